@@ -0,0 +1,87 @@
+#include "Bench.h"
+#include "Matrix.h"
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Gathers every shuffled batch of an epoch from feature-major data, one strided column at a time.
+ */
+template <typename T>
+static void gather_columns(Matrix<T>& out, const Matrix<T>& data, const std::vector<int>& order, int batch) {
+    for (int start { 0 }; start < data.cols(); start += batch) {
+        const int cols = std::min(batch, data.cols() - start);
+        out.resize(data.rows(), cols);
+        for (int r { 0 }; r < data.rows(); ++r) {
+            for (int j { 0 }; j < cols; ++j) {
+                out[r, j] = data[r, order[start + j]];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Gathers every shuffled batch of an epoch from sample-major data, one row copy per sample,
+ * optionally transposing each batch back to one sample per column.
+ */
+template <typename T>
+static void gather_rows(Matrix<T>& out, Matrix<T>& transposed, const Matrix<T>& data, const std::vector<int>& order, int batch, bool transpose) {
+    const std::size_t features = static_cast<std::size_t>(data.cols());
+    for (int start { 0 }; start < data.rows(); start += batch) {
+        const int rows = std::min(batch, data.rows() - start);
+        out.resize(rows, data.cols());
+        for (int j { 0 }; j < rows; ++j) {
+            std::memcpy(&out[j, 0], &data[order[start + j], 0], features * sizeof(T));
+        }
+        if (transpose) {
+            transpose_into(transposed, out);
+        }
+    }
+}
+
+/**
+ * @brief Compares the gathers of a shuffled epoch in both layouts.
+ */
+template <typename T>
+static void run(int samples, int batch, std::mt19937& gen) {
+    std::uniform_real_distribution<T> pixel(0.0, 1.0);
+    Matrix<T> feature_major { 784, samples };
+    for (int row { 0 }; row < 784; ++row) {
+        for (int col { 0 }; col < samples; ++col) {
+            feature_major[row, col] = pixel(gen);
+        }
+    }
+    const Matrix<T> sample_major = feature_major.transpose();
+
+    std::vector<int> order(samples);
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::shuffle(order, gen);
+
+    Matrix<T> out { 784, batch };
+    Matrix<T> rows { batch, 784 };
+    const double columns = bench::elapsed_ms([&] { gather_columns(out, feature_major, order, batch); });
+    const double copies = bench::elapsed_ms([&] { gather_rows(rows, out, sample_major, order, batch, false); });
+    const double transposed = bench::elapsed_ms([&] { gather_rows(rows, out, sample_major, order, batch, true); });
+
+    std::cout << std::format("{:>8} {:>6} {:>14.1f} {:>14.1f} {:>18.1f}\n",
+        sizeof(T) == 4 ? "float" : "double", batch, columns, copies, transposed);
+}
+
+int main() {
+    constexpr int samples = 60000;
+    std::mt19937 gen { 42 };
+
+    std::cout << std::format("\n[one shuffled epoch of {} samples of 784 features, times in ms]\n{:>8} {:>6} {:>14} {:>14} {:>18}\n",
+        samples, "type", "batch", "column gather", "row copies", "copies+transpose");
+    for (const int batch : {32, 64, 256}) {
+        run<float>(samples, batch, gen);
+    }
+    for (const int batch : {32, 64, 256}) {
+        run<double>(samples, batch, gen);
+    }
+    return 0;
+}
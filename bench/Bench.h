@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Matrix.h"
+#include <chrono>
+#include <random>
+
+/**
+ * @namespace bench
+ * @brief Contains the helpers shared by the benchmarks.
+ */
+namespace bench {
+
+    /**
+     * @brief Runs f once and returns the time it took in milliseconds.
+     * @param f The function to time.
+     * @return Elapsed time in milliseconds.
+     */
+    template <typename Function>
+    [[nodiscard]] double elapsed_ms(Function&& f) {
+        using clock = std::chrono::steady_clock;
+        const auto start = clock::now();
+        f();
+        return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    }
+
+    /**
+     * @brief Runs f repeatedly for roughly a fixed time and returns the mean time of one call in seconds.
+     * @param f The function to time.
+     * @param budget Minimum total running time (default = 300 ms).
+     * @return Mean time of one call in seconds.
+     */
+    template <typename Function>
+    [[nodiscard]] double seconds_per_call(Function&& f, std::chrono::milliseconds budget = std::chrono::milliseconds(300)) {
+        using clock = std::chrono::steady_clock;
+        int iterations = 0;
+        const auto start = clock::now();
+        auto elapsed = clock::duration::zero();
+        do {
+            f();
+            ++iterations;
+            elapsed = clock::now() - start;
+        } while (elapsed < budget);
+        return std::chrono::duration<double>(elapsed).count() / iterations;
+    }
+
+    /**
+     * @brief Builds a matrix filled with uniformly distributed values in [-1, 1].
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @param gen Random number generator.
+     * @return The random matrix.
+     */
+    template <typename T>
+    [[nodiscard]] Matrix<T> random_matrix(int rows, int cols, std::mt19937& gen) {
+        std::uniform_real_distribution<T> dist(-1.0, 1.0);
+        Matrix<T> matrix { rows, cols };
+        for (int row { 0 }; row < rows; ++row) {
+            for (int col { 0 }; col < cols; ++col) {
+                matrix[row, col] = dist(gen);
+            }
+        }
+        return matrix;
+    }
+}
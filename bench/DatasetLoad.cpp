@@ -0,0 +1,114 @@
+#include "Bench.h"
+#include "DataLoader.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Writes a 4-byte big-endian integer, as in an IDX header.
+ */
+static void write_header_int(std::ofstream& file, uint32_t value) {
+    const std::array<char, 4> bytes {
+        static_cast<char>(value >> 24), static_cast<char>(value >> 16),
+        static_cast<char>(value >> 8), static_cast<char>(value)
+    };
+    file.write(bytes.data(), 4);
+}
+
+/**
+ * @brief Writes MNIST-shaped IDX image and label files with random contents.
+ */
+static void write_dataset(const std::string& image_path, const std::string& label_path, int samples, std::mt19937& gen) {
+    std::uniform_int_distribution<int> pixel(0, 255);
+    std::uniform_int_distribution<int> digit(0, mnist::label_range - 1);
+
+    std::ofstream images { image_path, std::ios::binary };
+    write_header_int(images, mnist::IMAGE_MAGIC);
+    write_header_int(images, static_cast<uint32_t>(samples));
+    write_header_int(images, 28);
+    write_header_int(images, 28);
+    std::vector<char> image(784);
+    for (int i { 0 }; i < samples; ++i) {
+        std::ranges::generate(image, [&] { return static_cast<char>(pixel(gen)); });
+        images.write(image.data(), static_cast<std::streamsize>(image.size()));
+    }
+
+    std::ofstream labels { label_path, std::ios::binary };
+    write_header_int(labels, mnist::LABEL_MAGIC);
+    write_header_int(labels, static_cast<uint32_t>(samples));
+    for (int i { 0 }; i < samples; ++i) {
+        const char label = static_cast<char>(digit(gen));
+        labels.write(&label, 1);
+    }
+}
+
+/**
+ * @brief Compares loading a dataset into matrices, streamed or in parallel, with reading or mapping its bytes and gathering every batch of a shuffled epoch.
+ */
+template <typename T>
+static void run(const std::string& image_path, const std::string& label_path, std::mt19937& gen) {
+    constexpr int batch = 64;
+
+    std::size_t loaded_bytes = 0;
+    const double load = bench::elapsed_ms([&] {
+        const auto [X, y] = mnist::load<T>(image_path, label_path);
+        loaded_bytes = (static_cast<std::size_t>(X.rows()) * X.cols() + static_cast<std::size_t>(y.rows()) * y.cols()) * sizeof(T);
+    });
+
+    const double parallel = bench::elapsed_ms([&] {
+        const auto [X, y] = mnist::load<T>(image_path, label_path, 0, {.decode = mnist::Decode::Parallel});
+    });
+
+    const double read = bench::elapsed_ms([&] {
+        const Dataset bytes = mnist::load_dataset(image_path, label_path);
+    });
+
+    /* Mapping only reads the headers: the pixels are paged in by the first epoch */
+    const auto started = std::chrono::steady_clock::now();
+    const Dataset dataset = mnist::map(image_path, label_path);
+    const double map = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+
+    std::vector<int> order(dataset.samples());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::shuffle(order, gen);
+    Matrix<T> inputs { dataset.features(), batch };
+    Matrix<T> labels { dataset.classes(), batch };
+    const double epoch = bench::elapsed_ms([&] {
+        for (int start { 0 }; start < dataset.samples(); start += batch) {
+            const int end = std::min(start + batch, dataset.samples());
+            dataset.batch_into(inputs, order, start, end);
+            dataset.labels_into(labels, order, start, end);
+        }
+    });
+
+    std::cout << std::format("{:>8} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>12.1f} {:>12.1f}\n",
+        sizeof(T) == 4 ? "float" : "double",
+        load, parallel, read, map, epoch, loaded_bytes / 1048576.0, dataset.bytes() / 1048576.0);
+}
+
+int main() {
+    constexpr int samples = 60000;
+    std::mt19937 gen { 42 };
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::string image_path = (directory / "bench-images-idx3-ubyte").string();
+    const std::string label_path = (directory / "bench-labels-idx1-ubyte").string();
+    write_dataset(image_path, label_path, samples, gen);
+
+    std::cout << std::format("\n[{} samples of 784 pixels, times in ms, sizes in MiB]\n{:>8} {:>10} {:>10} {:>10} {:>10} {:>10} {:>12} {:>12}\n",
+        samples, "type", "load", "parallel", "read", "map", "epoch", "loaded size", "byte size");
+    run<float>(image_path, label_path, gen);
+    run<double>(image_path, label_path, gen);
+
+    std::filesystem::remove(image_path);
+    std::filesystem::remove(label_path);
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "Bench.h"
+#include "FixedNetwork.h"
+#include "NeuralNetwork.h"
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string_view>
+
+/**
+ * @brief Fills a fixed matrix with uniformly distributed values in [0, 1], like normalized pixels.
+ */
+template <typename T, int R, int C>
+static void fill_random(FixedMatrix<T, R, C>& matrix, std::mt19937& gen) {
+    std::uniform_real_distribution<T> dist(0.0, 1.0);
+    for (int row { 0 }; row < R; ++row) {
+        for (int col { 0 }; col < C; ++col) {
+            matrix[row, col] = dist(gen);
+        }
+    }
+}
+
+/**
+ * @brief Measures the dynamic and the fixed-shape network on a batch of B samples.
+ */
+template <typename T, int B, typename Fixed>
+static void run(const NeuralNetwork<T>& dynamic, const Fixed& fixed, std::mt19937& gen) {
+    FixedMatrix<T, Fixed::input_size, B> input;
+    fill_random(input, gen);
+    const Matrix<T> batch = input.to_matrix();
+
+    const Matrix<T> expected = dynamic.predict(batch);
+    const FixedMatrix<T, Fixed::output_size, B> actual = fixed.predict(input);
+    double error = 0.0;
+    for (int row { 0 }; row < Fixed::output_size; ++row) {
+        for (int col { 0 }; col < B; ++col) {
+            error = std::max(error, static_cast<double>(std::abs(expected[row, col] - actual[row, col])));
+        }
+    }
+
+    const double dynamic_us = 1e6 * bench::seconds_per_call([&] {
+        volatile T sink = dynamic.predict(batch)[0, 0];
+        (void) sink;
+    });
+    const double fixed_us = 1e6 * bench::seconds_per_call([&] {
+        volatile T sink = fixed.predict(input)[0, 0];
+        (void) sink;
+    });
+
+    std::cout << std::format("{:>6} {:>14.2f} {:>12.2f} {:>8.2f}x {:>10.1e}\n",
+        B, dynamic_us, fixed_us, dynamic_us / fixed_us, error);
+}
+
+int main() {
+    using T = float;
+
+    /* The 784 -> 64 -> 64 -> 10 network of src/main.cpp, with freshly initialized weights */
+    config::Network network_config {
+        .input_size = 784,
+        .layers = {
+            {64, activation::Type::ReLU, initialization::Type::He},
+            {64, activation::Type::ReLU, initialization::Type::He},
+            {10, activation::Type::Softmax, initialization::Type::Glorot},
+        },
+        .loss_type = loss::Type::CrossEntropy,
+        .weight_decay = 0.0,
+        .optimizer = {},
+        .regularization = {},
+    };
+    const NeuralNetwork<T> dynamic { network_config };
+    const auto fixed = std::make_unique<FixedNetwork<T, 784, 64, 64, 10>>(dynamic);
+
+    std::mt19937 gen { 42 };
+    std::cout << std::format("\n[float 784-64-64-10]\n{:>6} {:>14} {:>12} {:>9} {:>10}\n",
+        "batch", "dynamic us", "fixed us", "speedup", "max err");
+    run<T, 1>(dynamic, *fixed, gen);
+    run<T, 4>(dynamic, *fixed, gen);
+    run<T, 16>(dynamic, *fixed, gen);
+    run<T, 64>(dynamic, *fixed, gen);
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include "Bench.h"
+#include "Matrix.h"
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Reference i-k-j triple loop, kept as the baseline the GEMM engine is measured against.
+ */
+template <typename T>
+[[nodiscard]] static Matrix<T> reference_matmul(const Matrix<T>& lhs, const Matrix<T>& rhs) {
+    Matrix<T> product { lhs.rows(), rhs.cols() };
+    for (int i { 0 }; i < lhs.rows(); ++i) {
+        for (int k { 0 }; k < lhs.cols(); ++k) {
+            const T aik = lhs[i, k];
+            for (int j { 0 }; j < rhs.cols(); ++j) {
+                product[i, j] += aik * rhs[k, j];
+            }
+        }
+    }
+    return product;
+}
+
+/**
+ * @brief Runs a multiplication repeatedly for roughly a fixed time and returns the achieved GFLOP/s.
+ */
+template <typename Function>
+[[nodiscard]] static double gflops(int m, int n, int k, Function&& f) {
+    return 2.0 * m * n * k / bench::seconds_per_call(std::forward<Function>(f)) * 1e-9;
+}
+
+/**
+ * @brief Product shape measured by the benchmark.
+ */
+struct Shape {
+    std::string_view name;
+    int m, n, k;
+};
+
+/**
+ * @brief Measures the loop baseline and the GEMM engine on every shape for one element type.
+ */
+template <typename T>
+static void run(std::string_view precision, const std::vector<Shape>& shapes, std::mt19937& gen) {
+    std::cout << std::format("\n[{}]\n{:<22} {:>16} {:>12} {:>12} {:>8} {:>10}\n", precision,
+        "product", "m x n x k", "loop GF/s", "gemm GF/s", "speedup", "max err");
+
+    for (const auto& shape : shapes) {
+        const Matrix<T> a = bench::random_matrix<T>(shape.m, shape.k, gen);
+        const Matrix<T> b = bench::random_matrix<T>(shape.k, shape.n, gen);
+
+        const Matrix<T> expected = reference_matmul(a, b);
+        const Matrix<T> actual = a * b;
+        double error = 0.0;
+        for (int row { 0 }; row < expected.rows(); ++row) {
+            for (int col { 0 }; col < expected.cols(); ++col) {
+                error = std::max(error, static_cast<double>(std::abs(expected[row, col] - actual[row, col])));
+            }
+        }
+
+        const double loop = gflops(shape.m, shape.n, shape.k, [&] {
+            volatile T sink = reference_matmul(a, b)[0, 0];
+            (void) sink;
+        });
+        const double engine = gflops(shape.m, shape.n, shape.k, [&] {
+            volatile T sink = (a * b)[0, 0];
+            (void) sink;
+        });
+
+        std::cout << std::format("{:<22} {:>16} {:>12.2f} {:>12.2f} {:>7.2f}x {:>10.1e}\n",
+            shape.name,
+            std::format("{}x{}x{}", shape.m, shape.n, shape.k),
+            loop, engine, engine / loop, error);
+    }
+}
+
+int main() {
+    /* Products produced by the 784 -> 64 -> 64 -> 10 network with a batch of 64 */
+    constexpr int batch = 64;
+    const std::vector<Shape> shapes {
+        {"forward  w1 * x",        64,  batch, 784},
+        {"forward  w2 * a1",       64,  batch, 64},
+        {"forward  w3 * a2",       10,  batch, 64},
+        {"backward d1 * x^T",      64,  784,   batch},
+        {"backward w2^T * d2",     64,  batch, 64},
+        {"backward w1^T * d1",     784, batch, 64},
+        {"full batch w1 * x",      64,  1000,  784},
+    };
+
+    std::mt19937 gen { 42 };
+    run<double>("double", shapes, gen);
+    run<float>("float", shapes, gen);
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "Dataset.h"
+#include "NeuralNetwork.h"
+#include "Prefetch.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Builds an MNIST-shaped dataset with random pixels and labels.
+ */
+[[nodiscard]] static Dataset random_dataset(int samples, std::mt19937& gen) {
+    std::uniform_int_distribution<int> pixel(0, 255);
+    std::uniform_int_distribution<int> digit(0, 9);
+    std::vector<uint8_t> pixels(static_cast<std::size_t>(samples) * 784);
+    std::vector<uint8_t> labels(static_cast<std::size_t>(samples));
+    std::ranges::generate(pixels, [&] { return static_cast<uint8_t>(pixel(gen)); });
+    std::ranges::generate(labels, [&] { return static_cast<uint8_t>(digit(gen)); });
+    return Dataset { std::move(pixels), std::move(labels), 784, 10 };
+}
+
+/**
+ * @brief Trains on shuffled batches handed over by a pipeline and reports the time spent and the consumer stalls.
+ */
+template <typename T>
+static void run(const Dataset& dataset, const prefetch::Settings& settings, std::mt19937& gen) {
+    constexpr int batch = 64;
+    constexpr int epochs = 2;
+
+    NeuralNetwork<T> model { config::Network {
+        .input_size = 784,
+        .layers = {
+            {64, activation::Type::ReLU, initialization::Type::He},
+            {10, activation::Type::Softmax, initialization::Type::Glorot},
+        },
+        .loss_type = loss::Type::CrossEntropy,
+        .weight_decay = 0.0,
+        .optimizer = {.type = optimizer::Type::Adam, .beta1 = 0.9, .beta2 = 0.999},
+        .regularization = {},
+    } };
+
+    std::vector<int> order(dataset.samples());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::shuffle(order, gen);
+    const int batches_per_epoch = (dataset.samples() + batch - 1) / batch;
+
+    struct Batch {
+        Matrix<T> inputs;
+        Matrix<T> labels;
+    };
+    prefetch::Pipeline<Batch> pipeline {
+        settings, static_cast<std::size_t>(epochs) * batches_per_epoch,
+        [&] { return Batch { Matrix<T> { dataset.features(), batch }, Matrix<T> { dataset.classes(), batch } }; },
+        [&](Batch& slot, std::size_t index) {
+            const int start = static_cast<int>(index % batches_per_epoch) * batch;
+            const int end = std::min(start + batch, dataset.samples());
+            dataset.batch_into(slot.inputs, order, start, end);
+            dataset.labels_into(slot.labels, order, start, end);
+        }
+    };
+
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    pipeline.open(static_cast<std::size_t>(epochs) * batches_per_epoch);
+    for (int step { 0 }; step < epochs * batches_per_epoch; ++step) {
+        Batch& slot = pipeline.next();
+        model.train(slot.inputs, slot.labels, 0.001);
+        pipeline.release();
+    }
+    const double elapsed = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    const prefetch::Stats& stats = pipeline.stats();
+    std::cout << std::format("{:>8} {:>8} {:>6} {:>10.1f} {:>8} {:>10.2f}\n",
+        sizeof(T) == 4 ? "float" : "double", settings.workers, settings.depth,
+        elapsed, stats.stalls, stats.stall_ms);
+}
+
+int main() {
+    constexpr int samples = 10000;
+    std::mt19937 gen { 42 };
+    const Dataset dataset = random_dataset(samples, gen);
+
+    std::cout << std::format("\n[2 epochs of {} samples in batches of 64, 784-64-10 network, times in ms]\n{:>8} {:>8} {:>6} {:>10} {:>8} {:>10}\n",
+        samples, "type", "workers", "depth", "total", "stalls", "stalled");
+    for (const prefetch::Settings settings : {prefetch::Settings {0, 1}, prefetch::Settings {1, 4}, prefetch::Settings {2, 4}}) {
+        run<float>(dataset, settings, gen);
+    }
+    for (const prefetch::Settings settings : {prefetch::Settings {0, 1}, prefetch::Settings {1, 4}, prefetch::Settings {2, 4}}) {
+        run<double>(dataset, settings, gen);
+    }
+    return 0;
+}
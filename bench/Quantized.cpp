@@ -0,0 +1,71 @@
+#include "Bench.h"
+#include "NeuralNetwork.h"
+#include "Quantized.h"
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <random>
+
+/**
+ * @brief Measures the floating point and the int8 network on a batch of samples.
+ */
+template <typename T>
+static void run(const NeuralNetwork<T>& reference, const QuantizedNetwork<T>& quantized, int batch, std::mt19937& gen) {
+    Matrix<T> input(784, batch);
+    std::uniform_real_distribution<T> dist(0.0, 1.0);
+    for (int row { 0 }; row < input.rows(); ++row) {
+        for (int col { 0 }; col < batch; ++col) {
+            input[row, col] = dist(gen);
+        }
+    }
+
+    const Matrix<T> expected = reference.predict(input);
+    const Matrix<T> actual = quantized.predict(input);
+    double error = 0.0;
+    for (int row { 0 }; row < expected.rows(); ++row) {
+        for (int col { 0 }; col < batch; ++col) {
+            error = std::max(error, static_cast<double>(std::abs(expected[row, col] - actual[row, col])));
+        }
+    }
+
+    const double reference_us = 1e6 * bench::seconds_per_call([&] {
+        volatile T sink = reference.predict(input)[0, 0];
+        (void) sink;
+    });
+    const double quantized_us = 1e6 * bench::seconds_per_call([&] {
+        volatile T sink = quantized.predict(input)[0, 0];
+        (void) sink;
+    });
+
+    std::cout << std::format("{:>6} {:>14.2f} {:>12.2f} {:>8.2f}x {:>10.1e}\n",
+        batch, reference_us, quantized_us, reference_us / quantized_us, error);
+}
+
+int main() {
+    using T = float;
+
+    /* The 784 -> 64 -> 64 -> 10 network of src/main.cpp, with freshly initialized weights */
+    config::Network network_config {
+        .input_size = 784,
+        .layers = {
+            {64, activation::Type::ReLU, initialization::Type::He},
+            {64, activation::Type::ReLU, initialization::Type::He},
+            {10, activation::Type::Softmax, initialization::Type::Glorot},
+        },
+        .loss_type = loss::Type::CrossEntropy,
+        .weight_decay = 0.0,
+        .optimizer = {},
+        .regularization = {},
+    };
+    const NeuralNetwork<T> reference { network_config };
+    const QuantizedNetwork<T> quantized { reference };
+
+    std::mt19937 gen { 42 };
+    std::cout << std::format("\n[float 784-64-64-10, int8 kernel: {}, weights {} -> {} bytes]\n{:>6} {:>14} {:>12} {:>9} {:>10}\n",
+        quantization::kernel_name(), 784 * 64 * 4 + 64 * 64 * 4 + 64 * 10 * 4, quantized.weight_bytes(),
+        "batch", "float us", "int8 us", "speedup", "max err");
+    for (int batch : {1, 16, 64, 256, 1024}) {
+        run(reference, quantized, batch, gen);
+    }
+    return 0;
+}
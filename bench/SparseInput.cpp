@@ -0,0 +1,92 @@
+#include "Bench.h"
+#include "NeuralNetwork.h"
+#include "SparseMatrix.h"
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Builds an input matrix where a given fraction of the elements are non-zero, like normalized MNIST pixels.
+ */
+template <typename T>
+[[nodiscard]] static Matrix<T> random_input(int rows, int cols, double density, std::mt19937& gen) {
+    std::uniform_real_distribution<T> pixel(0.0, 1.0);
+    std::bernoulli_distribution lit(density);
+    Matrix<T> matrix { rows, cols };
+    for (int row { 0 }; row < rows; ++row) {
+        for (int col { 0 }; col < cols; ++col) {
+            matrix[row, col] = lit(gen) ? pixel(gen) : T { 0 };
+        }
+    }
+    return matrix;
+}
+
+/**
+ * @brief Measures dense and sparse first-layer products and full training steps at one input density.
+ */
+template <typename T>
+static void run(double density, std::mt19937& gen) {
+    constexpr int batch = 64;
+    const Matrix<T> dense = random_input<T>(784, batch, density, gen);
+    const SparseMatrix<T> sparse = SparseMatrix<T>::from_dense(dense);
+    Matrix<T> labels { 10, batch };
+    for (int col { 0 }; col < batch; ++col) {
+        labels[col % 10, col] = 1.0;
+    }
+
+    std::uniform_real_distribution<T> dist(-1.0, 1.0);
+    Matrix<T> w { 64, 784 };
+    Matrix<T> delta { 64, batch };
+    for (int row { 0 }; row < 64; ++row) {
+        for (int col { 0 }; col < 784; ++col) {
+            w[row, col] = dist(gen);
+        }
+        for (int col { 0 }; col < batch; ++col) {
+            delta[row, col] = dist(gen);
+        }
+    }
+    Matrix<T> z { 64, batch };
+    Matrix<T> dw { 64, 784 };
+
+    /* Training steps are longer than single predictions, so they get a longer time budget */
+    constexpr std::chrono::milliseconds budget { 500 };
+    const double forward_dense = 1e6 * bench::seconds_per_call([&] { matmul_into(z, w, dense); }, budget);
+    const double forward_sparse = 1e6 * bench::seconds_per_call([&] { matmul_into(z, w, sparse); }, budget);
+    const double grad_dense = 1e6 * bench::seconds_per_call([&] { matmul_into(dw, delta, dense.view().transpose()); }, budget);
+    const double grad_sparse = 1e6 * bench::seconds_per_call([&] { matmul_nt_into(dw, delta, sparse); }, budget);
+
+    config::Network network_config {
+        .input_size = 784,
+        .layers = {
+            {64, activation::Type::ReLU, initialization::Type::He},
+            {64, activation::Type::ReLU, initialization::Type::He},
+            {10, activation::Type::Softmax, initialization::Type::Glorot},
+        },
+        .loss_type = loss::Type::CrossEntropy,
+        .weight_decay = 0.0,
+        .optimizer = {},
+        .regularization = {},
+    };
+    NeuralNetwork<T> dense_model { network_config };
+    NeuralNetwork<T> sparse_model { network_config };
+    const double train_dense = 1e6 * bench::seconds_per_call([&] { dense_model.train(dense, labels, 0.001); }, budget);
+    const double train_sparse = 1e6 * bench::seconds_per_call([&] { sparse_model.train(sparse, labels, 0.001); }, budget);
+
+    std::cout << std::format("{:>8.0f}% {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>8.2f}x\n",
+        100.0 * sparse.density(),
+        forward_dense, forward_sparse, grad_dense, grad_sparse, train_dense, train_sparse,
+        train_dense / train_sparse);
+}
+
+int main() {
+    std::mt19937 gen { 42 };
+    std::cout << std::format("\n[float, 784 x 64 batch, times in us]\n{:>9} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10} {:>9}\n",
+        "non-zero", "fwd dense", "fwd sparse", "dw dense", "dw sparse", "step dense", "step sparse", "speedup");
+    /* MNIST images have about 19% non-zero pixels */
+    for (const double density : {0.05, 0.19, 0.5}) {
+        run<float>(density, gen);
+    }
+    return 0;
+}
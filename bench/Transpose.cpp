@@ -0,0 +1,88 @@
+#include "Bench.h"
+#include "Matrix.h"
+#include <format>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Reference row-by-row loop, kept as the baseline the blocked transpose is measured against.
+ */
+template <typename T>
+static void reference_transpose(Matrix<T>& out, const Matrix<T>& matrix) {
+    for (int row { 0 }; row < matrix.rows(); ++row) {
+        for (int col { 0 }; col < matrix.cols(); ++col) {
+            out[col, row] = matrix[row, col];
+        }
+    }
+}
+
+/**
+ * @brief Runs a transpose repeatedly for roughly a fixed time and returns the achieved GB/s (read + write).
+ */
+template <typename Function>
+[[nodiscard]] static double gbps(double bytes, Function&& f) {
+    return 2.0 * bytes / bench::seconds_per_call(std::forward<Function>(f)) * 1e-9;
+}
+
+/**
+ * @brief Matrix shape measured by the benchmark.
+ */
+struct Shape {
+    std::string_view name;
+    int rows, cols;
+};
+
+/**
+ * @brief Measures the loop baseline, the blocked transpose and the in-place transpose on every shape for one element type.
+ */
+template <typename T>
+static void run(std::string_view precision, const std::vector<Shape>& shapes, std::mt19937& gen) {
+    std::cout << std::format("\n[{}]\n{:<20} {:>10} {:>11} {:>13} {:>8} {:>14} {:>7}\n", precision,
+        "matrix", "shape", "loop GB/s", "blocked GB/s", "speedup", "in-place GB/s", "check");
+
+    for (const auto& shape : shapes) {
+        const Matrix<T> a = bench::random_matrix<T>(shape.rows, shape.cols, gen);
+        const double bytes = static_cast<double>(shape.rows) * shape.cols * sizeof(T);
+
+        Matrix<T> expected { shape.cols, shape.rows };
+        reference_transpose(expected, a);
+        Matrix<T> actual { shape.cols, shape.rows };
+        transpose_into(actual, a);
+        Matrix<T> in_place { a };
+        in_place.transpose_in_place();
+        const bool matches = actual == expected && in_place == expected;
+
+        Matrix<T> out { shape.cols, shape.rows };
+        const double loop = gbps(bytes, [&] { reference_transpose(out, a); });
+        const double blocked = gbps(bytes, [&] { transpose_into(out, a); });
+        Matrix<T> target { a };
+        const double inplace = gbps(bytes, [&] { target.transpose_in_place(); });
+
+        std::cout << std::format("{:<20} {:>10} {:>11.2f} {:>13.2f} {:>7.2f}x {:>14.2f} {:>7}\n",
+            shape.name,
+            std::format("{}x{}", shape.rows, shape.cols),
+            loop, blocked, blocked / loop, inplace, matches ? "ok" : "FAIL");
+    }
+}
+
+int main() {
+    /* Matrices transposed by the 784 -> 64 -> 64 -> 10 network with a batch of 64 */
+    constexpr int batch = 64;
+    const std::vector<Shape> shapes {
+        {"w1",                 64,  784},
+        {"w1^T",               784, 64},
+        {"w2",                 64,  64},
+        {"w3",                 10,  64},
+        {"batch x",            784, batch},
+        {"full batch x",       784, 1000},
+        {"square 1024",        1024, 1024},
+    };
+
+    std::mt19937 gen { 42 };
+    run<double>("double", shapes, gen);
+    run<float>("float", shapes, gen);
+    return 0;
+}
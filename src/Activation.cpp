@@ -1,78 +1,195 @@
 #include "Activation.h"
 #include <algorithm>
 #include <cmath>
+#include <format>
 #include <stdexcept>
 
-Matrix activation::apply(const Matrix& matrix, activation::Type type) {
+template <typename T>
+Matrix<T> activation::apply(const MatrixView<T>& matrix, activation::Type type) {
+    Matrix<T> out { matrix.rows(), matrix.cols() };
+    apply_into<T>(out, matrix, type);
+    return out;
+}
+
+template <typename T>
+void activation::apply_into(Matrix<T>& out, const ViewArg<T>& matrix, activation::Type type) {
     switch (type) {
         case Type::ReLU:
-            return matrix.apply(ReLU);
+            return ::apply_into(out, matrix, ReLU<T>);
         case Type::Sigmoid:
-            return matrix.apply(sigmoid);
+            return ::apply_into(out, matrix, sigmoid<T>);
         case Type::Softmax:
-            return softmax(matrix);
+            return softmax_into<T>(out, matrix);
+        default:
+            throw std::invalid_argument("unknown activation type");
+    }
+}
+
+/**
+ * @brief Returns the GEMM epilogue function of an activation type (None for softmax, which is not element-wise).
+ */
+[[nodiscard]] static gemm::Activation epilogue_activation(activation::Type type) {
+    switch (type) {
+        case activation::Type::ReLU:
+            return gemm::Activation::ReLU;
+        case activation::Type::Sigmoid:
+            return gemm::Activation::Sigmoid;
+        case activation::Type::Softmax:
+            return gemm::Activation::None;
         default:
             throw std::invalid_argument("unknown activation type");
     }
 }
 
-Matrix activation::apply_prime(const Matrix& matrix, activation::Type type) {
+template <typename T>
+void activation::linear_into(
+    Matrix<T>& z, Matrix<T>& out,
+    const ViewArg<T>& weights, const ViewArg<T>& input,
+    const ViewArg<T>& biases, activation::Type type
+) {
+    const gemm::Activation fused = epilogue_activation(type);
+    if (type != Type::Softmax) {
+        return matmul_into(z, out, weights, input, biases, fused);
+    }
+    if (&z == &out) {
+        Matrix<T> logits = Matrix<T>::scratch(weights.rows(), input.cols());
+        matmul_into(logits, logits, weights, input, biases, fused);
+        return softmax_into<T>(out, logits);
+    }
+    matmul_into(z, z, weights, input, biases, fused);
+    softmax_into<T>(out, z);
+}
+
+/**
+ * @brief Adds the bias of every row to z and writes f of the result to out, row by row.
+ */
+template <typename T, typename Function>
+static void bias_rows(Matrix<T>& z, Matrix<T>& out, const MatrixView<T>& biases, Function&& f) {
+    const int rows = z.rows();
+    const int cols = z.cols();
+    parallel::for_each_chunk(static_cast<size_t>(rows), 1, [&](size_t first, size_t last) {
+        for (int row { static_cast<int>(first) }; row < static_cast<int>(last); ++row) {
+            const T bias = biases[row, 0];
+            T* linear = &z[row, 0];
+            T* activated = &out[row, 0];
+            for (int col { 0 }; col < cols; ++col) {
+                linear[col] += bias;
+                activated[col] = f(linear[col]);
+            }
+        }
+    }, static_cast<size_t>(rows) * static_cast<size_t>(cols));
+}
+
+template <typename T>
+void activation::bias_apply_into(Matrix<T>& z, Matrix<T>& out, const ViewArg<T>& biases, activation::Type type) {
+    if (biases.rows() != z.rows() || biases.cols() != 1) {
+        throw std::invalid_argument(std::format(
+            "mismatched bias dimensions ({}x{}) must be ({}x1)",
+            biases.rows(), biases.cols(), z.rows()
+        ));
+    }
     switch (type) {
         case Type::ReLU:
-            return matrix.apply(ReLU_prime);
+            out.resize(z.rows(), z.cols());
+            return bias_rows(z, out, biases, ReLU<T>);
         case Type::Sigmoid:
-            return matrix.apply(sigmoid_prime);
+            out.resize(z.rows(), z.cols());
+            return bias_rows(z, out, biases, sigmoid<T>);
         case Type::Softmax:
-            throw std::logic_error("softmax derivative should be handled in loss calculation");
+            bias_rows(z, z, biases, [](T value) { return value; });
+            return softmax_into<T>(out, z);
         default:
             throw std::invalid_argument("unknown activation type");
     }
 }
 
-double activation::ReLU(double val) noexcept {
-    return val >= 0.0 ? val : 0.0;
+template <typename T>
+Matrix<T> activation::apply_prime(const MatrixView<T>& matrix, activation::Type type) {
+    Matrix<T> out { matrix.rows(), matrix.cols() };
+    apply_prime_into<T>(out, matrix, type);
+    return out;
+}
+
+template <typename T>
+void activation::apply_prime_into(Matrix<T>& out, const ViewArg<T>& matrix, activation::Type type) {
+    switch (type) {
+        case Type::ReLU:
+            return ::apply_into(out, matrix, ReLU_prime<T>);
+        case Type::Sigmoid:
+            return ::apply_into(out, matrix, sigmoid_prime<T>);
+        case Type::Softmax:
+            throw std::logic_error("softmax derivative should be handled in loss calculation");
+        default:
+            throw std::invalid_argument("unknown activation type");
+    }
 }
 
-double activation::ReLU_prime(double val) noexcept {
-    return val >= 0.0 ? 1.0 : 0.0;
+template <typename T>
+T activation::ReLU_prime(T val) noexcept {
+    return val >= T { 0 } ? T { 1 } : T { 0 };
 }
 
-double activation::sigmoid(double val) noexcept {
-    return 1.0 / (1.0 + std::exp(-val));
+template <typename T>
+T activation::sigmoid_prime(T val) noexcept {
+    const T sigmoid = T { 1 } / (T { 1 } + std::exp(-val));
+    return sigmoid * (T { 1 } - sigmoid);
 }
 
-double activation::sigmoid_prime(double val) noexcept {
-    const double sigmoid = 1.0 / (1.0 + std::exp(-val));
-    return sigmoid * (1.0 - sigmoid);
+template <typename T>
+Matrix<T> activation::softmax(const MatrixView<T>& logits) {
+    Matrix<T> out { logits.rows(), logits.cols() };
+    softmax_into<T>(out, logits);
+    return out;
 }
 
-Matrix activation::softmax(const Matrix& logits) {
+template <typename T>
+void activation::softmax_into(Matrix<T>& out, const ViewArg<T>& logits) {
     const int rows = logits.rows();
     const int cols = logits.cols();
-    Matrix out { rows, cols };
+    out.resize(rows, cols);
     
     for (int col { 0 }; col < cols; ++col) {
-        double col_max = logits[0, col];
+        T col_max = logits[0, col];
         
         for (int row { 1 }; row < rows; ++row) {
             col_max = std::max(col_max, logits[row, col]);
         }
         
-        double sum_exp = 0.0;
+        T sum_exp { 0 };
         for (int row { 0 }; row < rows; ++row) {
-            double exp = std::exp(logits[row, col] - col_max);
+            T exp = std::exp(logits[row, col] - col_max);
             out[row, col] = exp;
             sum_exp += exp;
         }
         
-        if (sum_exp == 0.0) {
+        if (sum_exp == T { 0 }) {
             throw std::logic_error("softmax encountered zero sum in column");
         }
 
-        double inverse_sum = 1 / sum_exp;
+        T inverse_sum = T { 1 } / sum_exp;
         for (int row { 0 }; row < rows; ++row) {
             out[row, col] *= inverse_sum;
         }
     }
-    return out;
 }
+
+template Matrix<float> activation::apply(const MatrixView<float>&, activation::Type);
+template void activation::apply_into(Matrix<float>&, const ViewArg<float>&, activation::Type);
+template void activation::linear_into(Matrix<float>&, Matrix<float>&, const ViewArg<float>&, const ViewArg<float>&, const ViewArg<float>&, activation::Type);
+template void activation::bias_apply_into(Matrix<float>&, Matrix<float>&, const ViewArg<float>&, activation::Type);
+template Matrix<float> activation::apply_prime(const MatrixView<float>&, activation::Type);
+template void activation::apply_prime_into(Matrix<float>&, const ViewArg<float>&, activation::Type);
+template float activation::ReLU_prime(float) noexcept;
+template float activation::sigmoid_prime(float) noexcept;
+template Matrix<float> activation::softmax(const MatrixView<float>&);
+template void activation::softmax_into(Matrix<float>&, const ViewArg<float>&);
+template Matrix<double> activation::apply(const MatrixView<double>&, activation::Type);
+template void activation::apply_into(Matrix<double>&, const ViewArg<double>&, activation::Type);
+template void activation::linear_into(Matrix<double>&, Matrix<double>&, const ViewArg<double>&, const ViewArg<double>&, const ViewArg<double>&, activation::Type);
+template void activation::bias_apply_into(Matrix<double>&, Matrix<double>&, const ViewArg<double>&, activation::Type);
+template Matrix<double> activation::apply_prime(const MatrixView<double>&, activation::Type);
+template void activation::apply_prime_into(Matrix<double>&, const ViewArg<double>&, activation::Type);
+template double activation::ReLU_prime(double) noexcept;
+template double activation::sigmoid_prime(double) noexcept;
+template Matrix<double> activation::softmax(const MatrixView<double>&);
+template void activation::softmax_into(Matrix<double>&, const ViewArg<double>&);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Matrix.h"
+#include <cmath>
 
 /**
  * @namespace activation
@@ -27,7 +28,58 @@ namespace activation {
      * @throws std::logic_error if the softmax function is applied and the sum of 
      * exponentials in any column is zero
      */
-    [[nodiscard]] Matrix apply(const Matrix& matrix, activation::Type type);
+    template <typename T>
+    [[nodiscard]] Matrix<T> apply(const MatrixView<T>& matrix, activation::Type type);
+
+    /**
+     * @brief Applies the specified activation function to a matrix, writing into a caller-owned destination.
+     * @param out Destination, resized to the shape of the matrix only if its shape differs.
+     * @param matrix The input matrix.
+     * @param type The type of activation function to apply.
+     * @throws std::invalid_argument if an unknown activation type is specified.
+     * @throws std::logic_error if the softmax function is applied and the sum of 
+     * exponentials in any column is zero
+     * @note out must not overlap matrix.
+     */
+    template <typename T>
+    void apply_into(Matrix<T>& out, const ViewArg<T>& matrix, activation::Type type);
+
+    /**
+     * @brief Computes a dense layer, z = weights * input + biases and out = f(z), in one pass over the output.
+     * @details ReLU and sigmoid run in the epilogue of the matrix product, on every tile of z as it is
+     * finished; softmax is not element-wise, so only the biases are fused and it runs on z afterwards.
+     * @param z Destination of the linear output, resized to (weights.rows() x input.cols()) only if its shape differs.
+     * @param out Destination of the activation, resized likewise; may be z itself to keep only the activation.
+     * @param weights The weight matrix.
+     * @param input The input matrix, one sample per column.
+     * @param biases The bias column, one value per row of weights.
+     * @param type The type of activation function to apply.
+     * @throws std::invalid_argument if the dimensions do not match or an unknown activation type is specified.
+     * @throws std::logic_error if the softmax function is applied and the sum of
+     * exponentials in any column is zero
+     * @note Neither z nor out may overlap weights or input.
+     */
+    template <typename T>
+    void linear_into(
+        Matrix<T>& z, Matrix<T>& out,
+        const ViewArg<T>& weights, const ViewArg<T>& input,
+        const ViewArg<T>& biases, activation::Type type
+    );
+
+    /**
+     * @brief Adds a bias column to a linear output in place and applies the activation into out in the same pass.
+     * @details Used where the product does not come from the dense engine, such as a sparse first layer.
+     * @param z The linear output, updated to z + biases.
+     * @param out Destination of the activation, resized to the shape of z only if its shape differs.
+     * @param biases The bias column, one value per row of z.
+     * @param type The type of activation function to apply.
+     * @throws std::invalid_argument if biases is not a z.rows() x 1 column or an unknown activation type is specified.
+     * @throws std::logic_error if the softmax function is applied and the sum of
+     * exponentials in any column is zero
+     * @note out must not overlap z.
+     */
+    template <typename T>
+    void bias_apply_into(Matrix<T>& z, Matrix<T>& out, const ViewArg<T>& biases, activation::Type type);
 
     /**
      * @brief Applies the derivative of the specified activation function to a matrix.
@@ -38,35 +90,54 @@ namespace activation {
      * @throws std::logic_error if the softmax function is applied, as its derivative
      * should be handled in the loss calculation.
      */
-    [[nodiscard]] Matrix apply_prime(const Matrix& matrix, activation::Type type);
+    template <typename T>
+    [[nodiscard]] Matrix<T> apply_prime(const MatrixView<T>& matrix, activation::Type type);
+
+    /**
+     * @brief Applies the derivative of the specified activation function to a matrix, writing into a caller-owned destination.
+     * @param out Destination, resized to the shape of the matrix only if its shape differs.
+     * @param matrix The input matrix.
+     * @param type The type of activation function to apply the derivative of.
+     * @throws std::invalid_argument if an unknown activation type is specified.
+     * @throws std::logic_error if the softmax function is applied, as its derivative
+     * should be handled in the loss calculation.
+     */
+    template <typename T>
+    void apply_prime_into(Matrix<T>& out, const ViewArg<T>& matrix, activation::Type type);
 
     /**
      * @brief Applies the ReLU activation function to a value.
      * @param val The input value.
      * @return The output value after applying ReLU.
+     * @note Defined in this header so the matrix product epilogue inlines the same definition.
      */
-    [[nodiscard]] double ReLU(double val) noexcept;
+    template <typename T>
+    [[nodiscard]] T ReLU(T val) noexcept;
 
     /**
      * @brief Applies the derivative of the ReLU activation function to a value.
      * @param val The input value.
      * @return The output value after applying the derivative of ReLU.
      */
-    [[nodiscard]] double ReLU_prime(double val) noexcept;
+    template <typename T>
+    [[nodiscard]] T ReLU_prime(T val) noexcept;
 
     /**
      * @brief Applies the sigmoid activation function to a value.
      * @param val The input value.
      * @return The output value after applying the sigmoid function.
+     * @note Defined in this header so the matrix product epilogue inlines the same definition.
      */
-    [[nodiscard]] double sigmoid(double val) noexcept;
+    template <typename T>
+    [[nodiscard]] T sigmoid(T val) noexcept;
 
     /**
      * @brief Applies the derivative of the sigmoid activation function to a value.
      * @param val The input value.
      * @return The output value after applying the derivative of the sigmoid function.
      */
-    [[nodiscard]] double sigmoid_prime(double val) noexcept;
+    template <typename T>
+    [[nodiscard]] T sigmoid_prime(T val) noexcept;
     
     /**
      * @brief Applies the softmax activation function to a matrix of logits.
@@ -75,5 +146,27 @@ namespace activation {
      * @throws std::logic_error if the sum of exponentials in any column is zero,
      * which can occur if all logits in that column are the same and equal to negative infinity
      */
-    [[nodiscard]] Matrix softmax(const Matrix& logits);
+    template <typename T>
+    [[nodiscard]] Matrix<T> softmax(const MatrixView<T>& logits);
+
+    /**
+     * @brief Applies the softmax activation function to a matrix of logits, writing into a caller-owned destination.
+     * @param out Destination, resized to the shape of the logits only if its shape differs.
+     * @param logits The input matrix containing logits.
+     * @throws std::logic_error if the sum of exponentials in any column is zero,
+     * which can occur if all logits in that column are the same and equal to negative infinity
+     * @note out must not overlap logits.
+     */
+    template <typename T>
+    void softmax_into(Matrix<T>& out, const ViewArg<T>& logits);
+}
+
+template <typename T>
+T activation::ReLU(T val) noexcept {
+    return val >= T { 0 } ? val : T { 0 };
+}
+
+template <typename T>
+T activation::sigmoid(T val) noexcept {
+    return T { 1 } / (T { 1 } + std::exp(-val));
 }
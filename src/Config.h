@@ -6,6 +6,7 @@
 #include "Loss.h"
 #include "Matrix.h"
 #include "Optimizer.h"
+#include "Prefetch.h"
 #include "Regularization.h"
 #include <vector>
 
@@ -45,7 +46,7 @@ namespace config {
      * @struct Training
      * @brief Represents the configuration for training a neural network.
      * @details Contains the number of epochs, batch size, shuffle flag, learning rate settings,
-     *          and whether to save the best model.
+     *          whether to save the best model, and how batches are assembled.
      */
     struct Training {
         int epochs = 20;                        ///< Number of epochs for training (default = 20)
@@ -53,16 +54,19 @@ namespace config {
         bool shuffle = true;                    ///< Shuffle training data (default = true)
         learning_rate::Settings learning_rate;  ///< Learning rate settings (default = constant = 0.001)
         bool best_model = true;                 ///< Save the best model during training (default = true)
+        prefetch::Settings prefetch;            ///< Background batch assembly settings (default = 1 worker, 4 batches ahead)
     };
 
     /**
      * @struct Validation
      * @brief Represents the configuration for validating a neural network.
      * @details Contains validation data, early stopping flag, and patience for early stopping.
+     * @tparam T Element type of the validation data.
      */
+    template <typename T>
     struct Validation {
-        Matrix& X;                  ///< Validation input data
-        Matrix& y;                  ///< Validation target data
+        MatrixView<T> X;            ///< Validation input data
+        MatrixView<T> y;            ///< Validation target data
         bool early_stop = true;     ///< Enable early stopping (default = true)
         int patience = 5;           ///< Patience for early stopping (default = 5)
     };
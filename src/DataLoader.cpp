@@ -1,8 +1,15 @@
 #include "DataLoader.h"
+#include "Simd.h"
+#include "ThreadPool.h"
+#include <algorithm>
 #include <array>
 #include <format>
 #include <fstream>
+#include <future>
+#include <span>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 /**
  * @brief Reads a 4-byte big-endian integer from the file.
@@ -16,11 +23,21 @@
         | value[3];
 }
 
-std::pair<Matrix, Matrix> mnist::load(
-    std::string_view image_path,
-    std::string_view label_path,
-    int limit
-) {
+/**
+ * @brief Image and label files of a dataset, positioned at their first sample.
+ */
+struct DatasetFiles {
+    std::ifstream images;
+    std::ifstream labels;
+    int pixels;     ///< Number of pixels of an image
+    int samples;    ///< Number of samples to read
+};
+
+/**
+ * @brief Opens the image and label files and checks their headers.
+ * @param limit Maximum number of samples to read (0 = all).
+ */
+[[nodiscard]] static DatasetFiles open_dataset(std::string_view image_path, std::string_view label_path, int limit) {
     std::ifstream images { std::string(image_path), std::ios::binary };
     if (!images) { throw std::runtime_error("could not open MNIST images file"); }
 
@@ -44,29 +61,264 @@ std::pair<Matrix, Matrix> mnist::load(
         limit = static_cast<int>(image_count);
     }
 
-    Matrix X(rows * cols, limit);
-    Matrix y(mnist::label_range, limit);
-    
-    std::vector<uint8_t> buffer(static_cast<size_t>(rows * cols));
-    uint8_t label;
+    return {std::move(images), std::move(labels), rows * cols, limit};
+}
 
-    for (int col { 0 }; col < limit; ++col) {
-        if (!images.read(reinterpret_cast<char*>(buffer.data()), 
-            static_cast<std::streamsize>(buffer.size()))) {
-                throw std::runtime_error(
-                    std::format("failed to read image data at sample {}", col));
-        }
-        if (!labels.read(reinterpret_cast<char*>(&label), 1)) {
+/**
+ * @brief Reads the next image and label of a dataset.
+ * @param sample Index of the sample, for error messages.
+ */
+static void read_sample(DatasetFiles& dataset, int sample, std::vector<uint8_t>& buffer, uint8_t& label) {
+    if (!dataset.images.read(reinterpret_cast<char*>(buffer.data()), 
+        static_cast<std::streamsize>(buffer.size()))) {
             throw std::runtime_error(
-                std::format("failed to read label data at sample {}", col));
+                std::format("failed to read image data at sample {}", sample));
+    }
+    if (!dataset.labels.read(reinterpret_cast<char*>(&label), 1)) {
+        throw std::runtime_error(
+            std::format("failed to read label data at sample {}", sample));
+    }
+}
+
+/**
+ * @brief Size of the image chunks read by the parallel decoding mode, in bytes.
+ */
+static constexpr std::size_t READ_CHUNK = 1 << 22;
+
+/**
+ * @brief Reads count whole images of a dataset into the front of a chunk buffer.
+ * @param first Index of the first image, for error messages.
+ */
+static void read_images(DatasetFiles& dataset, int first, int count, std::vector<uint8_t>& chunk) {
+    const std::size_t bytes = static_cast<std::size_t>(count) * static_cast<std::size_t>(dataset.pixels);
+    if (!dataset.images.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(bytes))) {
+        throw std::runtime_error(
+            std::format("failed to read image data at sample {}", first));
+    }
+}
+
+/**
+ * @brief Loads a dataset by reading its images in large chunks and decoding each chunk across the thread pool.
+ * @details All labels are read with a single call. The next chunk of images is read by a pool task
+ * while the current one is decoded, and every pool chunk normalizes a disjoint range of samples straight
+ * into its slice of the output matrices. The values are the same as those decoded sample by sample.
+ * @throws std::runtime_error if a file cannot be read or a label is out of range.
+ */
+template <typename T>
+[[nodiscard]] static std::pair<Matrix<T>, Matrix<T>> load_parallel(DatasetFiles& dataset, mnist::Layout layout) {
+    const bool sample_major = layout == mnist::Layout::SampleMajor;
+    const std::size_t pixels = static_cast<std::size_t>(dataset.pixels);
+    Matrix<T> X = sample_major ? Matrix<T>(dataset.samples, dataset.pixels) : Matrix<T>(dataset.pixels, dataset.samples);
+    Matrix<T> y = sample_major ? Matrix<T>(dataset.samples, mnist::label_range) : Matrix<T>(mnist::label_range, dataset.samples);
+
+    std::vector<uint8_t> labels(static_cast<size_t>(dataset.samples));
+    if (!dataset.labels.read(reinterpret_cast<char*>(labels.data()), static_cast<std::streamsize>(labels.size()))) {
+        throw std::runtime_error("failed to read label data");
+    }
+    const auto invalid = std::ranges::find_if(labels, [](uint8_t label) { return label >= mnist::label_range; });
+    if (invalid != labels.end()) {
+        throw std::runtime_error(std::format(
+            "label {} of sample {} out of range [0, {})", static_cast<int>(*invalid), invalid - labels.begin(), mnist::label_range));
+    }
+
+    const int per_chunk = std::max(1, static_cast<int>(READ_CHUNK / pixels));
+    std::array<std::vector<uint8_t>, 2> chunks;
+    for (std::vector<uint8_t>& chunk : chunks) {
+        chunk.resize(static_cast<std::size_t>(std::min(per_chunk, dataset.samples)) * pixels);
+    }
+
+    read_images(dataset, 0, std::min(per_chunk, dataset.samples), chunks[0]);
+    for (int first { 0 }, current { 0 }; first < dataset.samples; first += per_chunk, current ^= 1) {
+        const int count = std::min(per_chunk, dataset.samples - first);
+        const int next = first + count;
+
+        /* The reads stay sequential on one stream, each overlapping the decoding of the previous chunk
+           (a pool without workers runs the read inline, before the decoding) */
+        std::future<void> reading;
+        if (next < dataset.samples) {
+            reading = parallel::pool().submit([&dataset, &chunk = chunks[current ^ 1], next, per_chunk] {
+                read_images(dataset, next, std::min(per_chunk, dataset.samples - next), chunk);
+            });
+        }
+
+        const uint8_t* bytes = chunks[current].data();
+
+        /* The read must not outlive the buffers, even if the decoding throws */
+        try {
+            parallel::for_each_chunk(static_cast<size_t>(count), 16, [&](size_t begin, size_t end) {
+                const int lo = first + static_cast<int>(begin);
+                const int hi = first + static_cast<int>(end);
+                if (sample_major) {
+                    for (int row { lo }; row < hi; ++row) {
+                        simd::from_bytes<T>(&X[row, 0], bytes + static_cast<std::size_t>(row - first) * pixels, T { 255 }, pixels);
+                        y[row, labels[row]] = 1.0;
+                    }
+                    return;
+                }
+                for (int row { 0 }; row < dataset.pixels; ++row) {
+                    for (int col { lo }; col < hi; ++col) {
+                        X[row, col] = static_cast<T>(bytes[static_cast<std::size_t>(col - first) * pixels + row] / 255.0);
+                    }
+                }
+                for (int col { lo }; col < hi; ++col) {
+                    y[labels[col], col] = 1.0;
+                }
+            }, static_cast<size_t>(count) * pixels);
+        } catch (...) {
+            if (reading.valid()) {
+                reading.wait();
+            }
+            throw;
         }
+        if (reading.valid()) {
+            reading.get();
+        }
+    }
+
+    return {std::move(X), std::move(y)};
+}
+
+template <typename T>
+std::pair<Matrix<T>, Matrix<T>> mnist::load(
+    std::string_view image_path,
+    std::string_view label_path,
+    int limit,
+    const Settings& settings
+) {
+    DatasetFiles dataset = open_dataset(image_path, label_path, limit);
+
+    if (settings.decode == Decode::Parallel) {
+        return load_parallel<T>(dataset, settings.layout);
+    }
+
+    if (settings.layout == Layout::SampleMajor) {
+        Matrix<T> X(dataset.samples, dataset.pixels);
+        Matrix<T> y(dataset.samples, mnist::label_range);
+
+        std::vector<uint8_t> buffer(static_cast<size_t>(dataset.pixels));
+        uint8_t label;
+
+        /* Every image is converted into its own contiguous row */
+        for (int row { 0 }; row < dataset.samples; ++row) {
+            read_sample(dataset, row, buffer, label);
+            simd::from_bytes<T>(&X[row, 0], buffer.data(), T { 255 }, buffer.size());
+            y[row, label] = 1.0;
+        }
+
+        return {std::move(X), std::move(y)};
+    }
+
+    Matrix<T> X(dataset.pixels, dataset.samples);
+    Matrix<T> y(mnist::label_range, dataset.samples);
+    
+    std::vector<uint8_t> buffer(static_cast<size_t>(dataset.pixels));
+    uint8_t label;
+
+    for (int col { 0 }; col < dataset.samples; ++col) {
+        read_sample(dataset, col, buffer, label);
 
         for (int row { 0 }; row < X.rows(); ++row) {
-            X[row, col] = buffer[row] / 255.0;
+            X[row, col] = static_cast<T>(buffer[row] / 255.0);
+        }
+
+        y[label, col] = 1.0;
+    }
+
+    return {std::move(X), std::move(y)};
+}
+
+template <typename T>
+std::pair<SparseMatrix<T>, Matrix<T>> mnist::load_sparse(
+    std::string_view image_path,
+    std::string_view label_path,
+    int limit
+) {
+    DatasetFiles dataset = open_dataset(image_path, label_path, limit);
+
+    SparseMatrix<T> X(dataset.pixels);
+    Matrix<T> y(mnist::label_range, dataset.samples);
+
+    std::vector<uint8_t> buffer(static_cast<size_t>(dataset.pixels));
+    std::vector<T> column(static_cast<size_t>(dataset.pixels));
+    uint8_t label;
+
+    for (int col { 0 }; col < dataset.samples; ++col) {
+        read_sample(dataset, col, buffer, label);
+
+        for (int row { 0 }; row < dataset.pixels; ++row) {
+            column[row] = static_cast<T>(buffer[row] / 255.0);
         }
+        X.append_column(column);
 
         y[label, col] = 1.0;
     }
 
-    return {X, y};
+    return {std::move(X), std::move(y)};
 }
+
+Dataset mnist::load_dataset(std::string_view image_path, std::string_view label_path, int limit) {
+    DatasetFiles dataset = open_dataset(image_path, label_path, limit);
+
+    /* The samples are stored as in the files, so each file is read with a single call */
+    std::vector<uint8_t> pixels(static_cast<size_t>(dataset.pixels) * static_cast<size_t>(dataset.samples));
+    std::vector<uint8_t> labels(static_cast<size_t>(dataset.samples));
+    if (!dataset.images.read(reinterpret_cast<char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()))) {
+        throw std::runtime_error("failed to read image data");
+    }
+    if (!dataset.labels.read(reinterpret_cast<char*>(labels.data()), static_cast<std::streamsize>(labels.size()))) {
+        throw std::runtime_error("failed to read label data");
+    }
+
+    try {
+        return Dataset { std::move(pixels), std::move(labels), dataset.pixels, mnist::label_range };
+    } catch (const std::invalid_argument& error) {
+        throw std::runtime_error(std::format("invalid MNIST dataset: {}", error.what()));
+    }
+}
+
+/**
+ * @brief Reads a 4-byte big-endian integer from a mapped header.
+ * @throws std::runtime_error if the file is shorter than the header.
+ */
+[[nodiscard]] static int32_t read_header_int(std::span<const uint8_t> bytes, std::size_t offset) {
+    if (bytes.size() < offset + 4) {
+        throw std::runtime_error("truncated MNIST header");
+    }
+    return bytes[offset] << 24
+        | bytes[offset + 1] << 16
+        | bytes[offset + 2] << 8
+        | bytes[offset + 3];
+}
+
+Dataset mnist::map(std::string_view image_path, std::string_view label_path, int limit) {
+    MappedFile images { image_path };
+    MappedFile labels { label_path };
+
+    if (read_header_int(images.bytes(), 0) != mnist::IMAGE_MAGIC || 
+        read_header_int(labels.bytes(), 0) != mnist::LABEL_MAGIC) {
+        throw std::runtime_error("unmatched MNIST header magic numbers");
+    }
+
+    int32_t image_count = read_header_int(images.bytes(), 4);
+    int32_t label_count = read_header_int(labels.bytes(), 4);
+    if (image_count != label_count) {
+        throw std::runtime_error("unmatched number of images and labels");
+    }
+
+    int rows = static_cast<int>(read_header_int(images.bytes(), 8));
+    int cols = static_cast<int>(read_header_int(images.bytes(), 12));
+    if (limit <= 0 || limit > static_cast<int>(image_count)) {
+        limit = static_cast<int>(image_count);
+    }
+
+    try {
+        return Dataset { std::move(images), 16, std::move(labels), 8, rows * cols, limit, mnist::label_range };
+    } catch (const std::invalid_argument& error) {
+        throw std::runtime_error(std::format("invalid MNIST dataset: {}", error.what()));
+    }
+}
+
+template std::pair<Matrix<float>, Matrix<float>> mnist::load(std::string_view, std::string_view, int, const Settings&);
+template std::pair<Matrix<double>, Matrix<double>> mnist::load(std::string_view, std::string_view, int, const Settings&);
+template std::pair<SparseMatrix<float>, Matrix<float>> mnist::load_sparse(std::string_view, std::string_view, int);
+template std::pair<SparseMatrix<double>, Matrix<double>> mnist::load_sparse(std::string_view, std::string_view, int);
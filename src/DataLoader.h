@@ -1,6 +1,8 @@
 #pragma once
 
+#include "Dataset.h"
 #include "Matrix.h"
+#include "SparseMatrix.h"
 #include <cstdint>
 #include <string_view>
 
@@ -13,15 +15,92 @@ namespace mnist {
     constexpr uint32_t LABEL_MAGIC = 0x00000801;
     constexpr int label_range = 10;
 
+    /**
+     * @enum Layout
+     * @brief Enum representing how the samples are laid out in the loaded matrices.
+     */
+    enum class Layout {
+        FeatureMajor,   ///< One sample per column (features x samples)
+        SampleMajor     ///< One sample per row (samples x features), so every image is contiguous
+    };
+
+    /**
+     * @enum Decode
+     * @brief Enum representing how the files are read and decoded into matrices.
+     */
+    enum class Decode {
+        Streamed,   ///< Sample by sample, alternating between the image and label files
+        Parallel    ///< In large chunks, each decoded and normalized across the thread pool while the next one is read
+    };
+
+    /**
+     * @struct Settings
+     * @brief Contains settings for loading a dataset into matrices.
+     */
+    struct Settings {
+        Layout layout = Layout::FeatureMajor;   ///< Layout of the samples in both matrices (default = FeatureMajor)
+        Decode decode = Decode::Streamed;       ///< How the files are read and decoded (default = Streamed)
+    };
+
     /**
      * @brief Loads MNIST dataset images and labels into a pair of matrices.
+     * @tparam T Element type of the matrices.
      * @param image_path Path to the images file.
      * @param label_path Path to the labels file.
      * @param limit Maximum number of samples to load from dataset (default = 0 = all).
+     * @param settings Layout of the matrices and decoding mode (default = feature-major, streamed).
      * @return Pair of matrices: (images, labels).
      * @throws std::runtime_error if files cannot be loaded or read correctly.
+     * @note Sample-major matrices are used through their transposed views, which have one sample per
+     * column like feature-major ones: shuffled batches are then gathered with one copy per sample.
+     */
+    template <typename T>
+    [[nodiscard]] std::pair<Matrix<T>, Matrix<T>> load(
+        std::string_view image_path,
+        std::string_view label_path,
+        int limit = 0,
+        const Settings& settings = {}
+    );
+
+    /**
+     * @brief Loads MNIST dataset images as a sparse matrix and labels as a dense matrix.
+     * @tparam T Element type of the matrices.
+     * @param image_path Path to the images file.
+     * @param label_path Path to the labels file.
+     * @param limit Maximum number of samples to load from dataset (default = 0 = all).
+     * @return Pair of matrices: (images, labels). Only the non-zero pixels of the images are stored.
+     * @throws std::runtime_error if files cannot be loaded or read correctly.
+     */
+    template <typename T>
+    [[nodiscard]] std::pair<SparseMatrix<T>, Matrix<T>> load_sparse(
+        std::string_view image_path,
+        std::string_view label_path,
+        int limit = 0
+    );
+
+    /**
+     * @brief Reads MNIST dataset images and labels as their raw bytes.
+     * @param image_path Path to the images file.
+     * @param label_path Path to the labels file.
+     * @param limit Maximum number of samples to load from dataset (default = 0 = all).
+     * @return Dataset owning one byte per pixel and one class index per sample.
+     * @throws std::runtime_error if files cannot be loaded or read correctly.
+     */
+    [[nodiscard]] Dataset load_dataset(
+        std::string_view image_path,
+        std::string_view label_path,
+        int limit = 0
+    );
+
+    /**
+     * @brief Maps MNIST dataset images and labels into memory without reading or converting them.
+     * @param image_path Path to the images file.
+     * @param label_path Path to the labels file.
+     * @param limit Maximum number of samples to expose from dataset (default = 0 = all).
+     * @return Dataset over the raw uint8 pixels and labels of the files; pages are loaded on first access.
+     * @throws std::runtime_error if files cannot be mapped or their headers do not match.
      */
-    [[nodiscard]] std::pair<Matrix, Matrix> load(
+    [[nodiscard]] Dataset map(
         std::string_view image_path,
         std::string_view label_path,
         int limit = 0
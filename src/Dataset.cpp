@@ -0,0 +1,115 @@
+#include "Dataset.h"
+#include "Simd.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @brief Checks that the dimensions of a dataset are positive.
+ * @throws std::invalid_argument if features, samples or classes is not positive.
+ */
+static void check_dimensions(int features, int samples, int classes) {
+    if (features <= 0 || samples <= 0 || classes <= 0) {
+        throw std::invalid_argument(std::format(
+            "invalid dataset dimensions ({} features, {} samples, {} classes) must be >= 1",
+            features, samples, classes
+        ));
+    }
+}
+
+/**
+ * @brief Checks that every label is a class index.
+ * @throws std::invalid_argument if a label is not below classes.
+ */
+static void check_labels(std::span<const uint8_t> labels, int classes) {
+    const auto invalid = std::ranges::find_if(labels, [classes](uint8_t label) { return label >= classes; });
+    if (invalid != labels.end()) {
+        throw std::invalid_argument(std::format(
+            "label {} of sample {} out of range [0, {})", static_cast<int>(*invalid), invalid - labels.begin(), classes));
+    }
+}
+
+Dataset::Dataset(
+    MappedFile images, std::size_t image_offset,
+    MappedFile labels, std::size_t label_offset,
+    int features, int samples, int classes
+)
+    : storage {Mapped {std::move(images), std::move(labels)}}
+    , m_features {features}
+    , m_samples {samples}
+    , m_classes {classes}
+{
+    check_dimensions(features, samples, classes);
+    const Mapped& files = std::get<Mapped>(storage);
+    const std::size_t pixel_count = static_cast<std::size_t>(features) * static_cast<std::size_t>(samples);
+    const std::span<const uint8_t> image_bytes = files.images.bytes();
+    const std::span<const uint8_t> label_bytes = files.labels.bytes();
+    if (image_offset > image_bytes.size() || image_bytes.size() - image_offset < pixel_count) {
+        throw std::invalid_argument(std::format(
+            "image file holds {} bytes, {} needed", image_bytes.size(), image_offset + pixel_count));
+    }
+    if (label_offset > label_bytes.size() || label_bytes.size() - label_offset < static_cast<std::size_t>(samples)) {
+        throw std::invalid_argument(std::format(
+            "label file holds {} bytes, {} needed", label_bytes.size(), label_offset + samples));
+    }
+    m_pixels = image_bytes.subspan(image_offset, pixel_count);
+    m_labels = label_bytes.subspan(label_offset, static_cast<std::size_t>(samples));
+    check_labels(m_labels, classes);
+}
+
+Dataset::Dataset(std::vector<uint8_t> pixels, std::vector<uint8_t> labels, int features, int classes)
+    : storage {Owned {std::move(pixels), std::move(labels)}}
+    , m_features {features}
+    , m_samples {static_cast<int>(std::get<Owned>(storage).labels.size())}
+    , m_classes {classes}
+{
+    check_dimensions(features, m_samples, classes);
+    const Owned& bytes = std::get<Owned>(storage);
+    const std::size_t pixel_count = static_cast<std::size_t>(features) * static_cast<std::size_t>(m_samples);
+    if (bytes.pixels.size() != pixel_count) {
+        throw std::invalid_argument(std::format(
+            "{} pixels given for {} samples of {} features", bytes.pixels.size(), m_samples, features));
+    }
+    m_pixels = bytes.pixels;
+    m_labels = bytes.labels;
+    check_labels(m_labels, classes);
+}
+
+template <typename T>
+void Dataset::samples_into(Matrix<T>& out, const std::vector<int>& idx, int start, int end) const {
+    const int rows = end - start;
+    out.resize(rows, m_features);
+    const std::size_t stride = static_cast<std::size_t>(m_features);
+
+    parallel::for_each_chunk(static_cast<size_t>(rows), 1, [&](size_t first, size_t last) {
+        for (int j { static_cast<int>(first) }; j < static_cast<int>(last); ++j) {
+            simd::from_bytes<T>(&out[j, 0], m_pixels.data() + static_cast<std::size_t>(idx[start + j]) * stride, T { 255 }, stride);
+        }
+    }, static_cast<size_t>(rows) * stride);
+}
+
+template <typename T>
+void Dataset::batch_into(Matrix<T>& out, const std::vector<int>& idx, int start, int end) const {
+    Matrix<T> samples = Matrix<T>::scratch(end - start, m_features);
+    samples_into(samples, idx, start, end);
+    transpose_into(out, samples);
+}
+
+template <typename T>
+void Dataset::labels_into(Matrix<T>& out, const std::vector<int>& idx, int start, int end) const {
+    const int cols = end - start;
+    out.resize(m_classes, cols);
+    out.fill(0.0);
+    for (int j { 0 }; j < cols; ++j) {
+        out[m_labels[idx[start + j]], j] = T { 1 };
+    }
+}
+
+template void Dataset::samples_into(Matrix<float>&, const std::vector<int>&, int, int) const;
+template void Dataset::samples_into(Matrix<double>&, const std::vector<int>&, int, int) const;
+template void Dataset::batch_into(Matrix<float>&, const std::vector<int>&, int, int) const;
+template void Dataset::batch_into(Matrix<double>&, const std::vector<int>&, int, int) const;
+template void Dataset::labels_into(Matrix<float>&, const std::vector<int>&, int, int) const;
+template void Dataset::labels_into(Matrix<double>&, const std::vector<int>&, int, int) const;
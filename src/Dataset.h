@@ -0,0 +1,170 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "Matrix.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <variant>
+#include <vector>
+
+/**
+ * @class Dataset
+ * @brief Samples kept as the raw bytes of their files: uint8 pixels and uint8 class labels.
+ * @details The images are stored one after the other, each as a contiguous run of features()
+ * pixels, exactly as in an IDX file, so a dataset can be a memory mapping of its files and opening
+ * it costs page faults only; it can also own its bytes. A sample takes one byte per pixel and one
+ * for its label, instead of a floating-point column and a one-hot column. Batches are converted to
+ * floating point, and normalized to [0, 1], while they are gathered.
+ */
+class Dataset {
+public:
+    /**
+     * @brief Constructs a dataset over mapped image and label files.
+     * @param images Mapping of the image file.
+     * @param image_offset Offset of the first pixel in the image file, past its header.
+     * @param labels Mapping of the label file.
+     * @param label_offset Offset of the first label in the label file, past its header.
+     * @param features Number of pixels of an image.
+     * @param samples Number of samples to expose.
+     * @param classes Number of classes the labels range over.
+     * @throws std::invalid_argument if features, samples or classes is not positive, if a file is too short,
+     * or if a label is not below classes.
+     */
+    Dataset(
+        MappedFile images, std::size_t image_offset,
+        MappedFile labels, std::size_t label_offset,
+        int features, int samples, int classes
+    );
+
+    /**
+     * @brief Constructs a dataset owning its pixels and labels.
+     * @param pixels Pixels of every image, image after image.
+     * @param labels Class of every sample; their number is the number of samples.
+     * @param features Number of pixels of an image.
+     * @param classes Number of classes the labels range over.
+     * @throws std::invalid_argument if features, classes or the number of labels is not positive,
+     * if there are not features pixels per label, or if a label is not below classes.
+     */
+    Dataset(std::vector<uint8_t> pixels, std::vector<uint8_t> labels, int features, int classes);
+
+    /**
+     * @brief Returns the number of pixels of an image.
+     * @return Number of features per sample.
+     */
+    [[nodiscard]] int features() const noexcept { return m_features; }
+
+    /**
+     * @brief Returns the number of samples.
+     * @return Number of samples.
+     */
+    [[nodiscard]] int samples() const noexcept { return m_samples; }
+
+    /**
+     * @brief Returns the number of classes the labels range over.
+     * @return Number of classes.
+     */
+    [[nodiscard]] int classes() const noexcept { return m_classes; }
+
+    /**
+     * @brief Returns the pixels of every image, image after image.
+     * @return samples() x features() pixels.
+     */
+    [[nodiscard]] std::span<const uint8_t> pixels() const noexcept { return m_pixels; }
+
+    /**
+     * @brief Returns the class of every sample.
+     * @return samples() labels.
+     */
+    [[nodiscard]] std::span<const uint8_t> labels() const noexcept { return m_labels; }
+
+    /**
+     * @brief Returns the size of the pixels and labels.
+     * @return Size in bytes, one per pixel and per label.
+     */
+    [[nodiscard]] std::size_t bytes() const noexcept { return m_pixels.size() + m_labels.size(); }
+
+    /**
+     * @brief Gathers a range of samples, in a given order, into a normalized sample-major batch.
+     * @tparam T Element type of the batch.
+     * @param out Destination, resized to ((end - start) x features()) only if its shape differs; one sample per row.
+     * @param idx The order of indices to select samples from.
+     * @param start The starting index for the range of samples to select.
+     * @param end The ending index for the range of samples to select.
+     * @note Every sample is a contiguous run of bytes converted into a contiguous row with one vectorized
+     * pass (simd::from_bytes), so nothing is strided. Pass out.view().transpose() where a batch with one
+     * sample per column is expected: the GEMM reads the transposed view in place.
+     */
+    template <typename T>
+    void samples_into(Matrix<T>& out, const std::vector<int>& idx, int start, int end) const;
+
+    /**
+     * @brief Gathers a range of samples, in a given order, into a normalized batch.
+     * @details The samples are gathered with samples_into and transposed with the blocked transpose_into.
+     * @tparam T Element type of the batch.
+     * @param out Destination, resized to (features() x (end - start)) only if its shape differs; one sample per column.
+     * @param idx The order of indices to select samples from.
+     * @param start The starting index for the range of samples to select.
+     * @param end The ending index for the range of samples to select.
+     */
+    template <typename T>
+    void batch_into(Matrix<T>& out, const std::vector<int>& idx, int start, int end) const;
+
+    /**
+     * @brief Gathers the labels of a range of samples, in a given order, as one-hot columns.
+     * @tparam T Element type of the labels.
+     * @param out Destination, resized to (classes() x (end - start)) only if its shape differs.
+     * @param idx The order of indices to select samples from.
+     * @param start The starting index for the range of samples to select.
+     * @param end The ending index for the range of samples to select.
+     * @note Labels are checked when the dataset is constructed, so the fused loss can read labels() as class indices.
+     */
+    template <typename T>
+    void labels_into(Matrix<T>& out, const std::vector<int>& idx, int start, int end) const;
+private:
+    /**
+     * @brief Mappings of the image and label files.
+     */
+    struct Mapped {
+        MappedFile images;
+        MappedFile labels;
+    };
+
+    /**
+     * @brief Pixels and labels owned by the dataset.
+     */
+    struct Owned {
+        std::vector<uint8_t> pixels;
+        std::vector<uint8_t> labels;
+    };
+
+    /**
+     * @brief Storage of the bytes; moving either alternative keeps its bytes in place, so the spans stay valid.
+     */
+    std::variant<Mapped, Owned> storage;
+
+    /**
+     * @brief Pixels of every image, within storage.
+     */
+    std::span<const uint8_t> m_pixels;
+
+    /**
+     * @brief Class of every sample, within storage.
+     */
+    std::span<const uint8_t> m_labels;
+
+    /**
+     * @brief Number of pixels of an image.
+     */
+    int m_features;
+
+    /**
+     * @brief Number of samples.
+     */
+    int m_samples;
+
+    /**
+     * @brief Number of classes.
+     */
+    int m_classes;
+};
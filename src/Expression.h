@@ -0,0 +1,294 @@
+#pragma once
+
+#include "ThreadPool.h"
+#include <concepts>
+#include <cstddef>
+#include <format>
+#include <stdexcept>
+#include <type_traits>
+
+template <typename T>
+class Matrix;
+
+/**
+ * @namespace expression
+ * @brief Contains the lazy element-wise expressions built by the Matrix arithmetic operators.
+ * @details Adding, subtracting, scaling or taking the Hadamard product of matrices only records
+ * the operation. The whole expression is then evaluated in a single pass, without temporaries,
+ * when it is assigned to a Matrix (or added to or subtracted from one).
+ * @note Expressions refer to their matrix operands, so they must be evaluated before those operands
+ * are destroyed. Assign them to a Matrix instead of storing them with auto.
+ */
+namespace expression {
+
+    template <typename Derived>
+    class Expression;
+
+    /**
+     * @brief Satisfied by the lazy expression types.
+     */
+    template <typename T>
+    concept Node = std::derived_from<T, Expression<T>>;
+
+    /**
+     * @brief Tells whether a type is a Matrix of any element type.
+     */
+    template <typename T>
+    inline constexpr bool is_matrix = false;
+
+    template <typename T>
+    inline constexpr bool is_matrix<Matrix<T>> = true;
+
+    /**
+     * @brief Satisfied by the types that can appear in an expression: matrices and other expressions.
+     */
+    template <typename T>
+    concept Operand = Node<std::remove_cvref_t<T>> || is_matrix<std::remove_cvref_t<T>>;
+
+    /**
+     * @brief Element type of an operand.
+     */
+    template <Operand T>
+    using value_t = typename std::remove_cvref_t<T>::value_type;
+
+    /**
+     * @class Expression
+     * @brief Base class of every lazy expression, providing the operations shared by all of them.
+     * @tparam Derived The expression type deriving from this class.
+     */
+    template <typename Derived>
+    class Expression {
+    public:
+        /**
+         * @brief Returns the lazy Hadamard product of this expression and another operand.
+         * @param rhs The operand to multiply with.
+         * @return Expression of the element-wise product.
+         * @throws std::invalid_argument if the dimensions do not match.
+         */
+        template <Operand Rhs>
+        [[nodiscard]] auto hadamard(const Rhs& rhs) const;
+    };
+
+    /**
+     * @class Leaf
+     * @brief Expression reading the elements of a matrix.
+     * @tparam T Element type of the matrix.
+     */
+    template <typename T>
+    class Leaf final : public Expression<Leaf<T>> {
+    public:
+        using value_type = T;
+
+        /**
+         * @brief Constructs a leaf over all the elements of a matrix.
+         * @param matrix The matrix to read.
+         */
+        explicit Leaf(const Matrix<T>& matrix) noexcept;
+
+        [[nodiscard]] int rows() const noexcept { return m_rows; }
+        [[nodiscard]] int cols() const noexcept { return m_cols; }
+        [[nodiscard]] T operator[](std::size_t index) const noexcept { return m_data[index]; }
+    private:
+        /**
+         * @brief Pointer to the first element of the matrix.
+         */
+        const T* m_data;
+
+        /**
+         * @brief Number of rows in the matrix.
+         */
+        int m_rows;
+
+        /**
+         * @brief Number of columns in the matrix.
+         */
+        int m_cols;
+    };
+
+    /**
+     * @class Scaled
+     * @brief Expression multiplying every element of another expression by a scalar.
+     * @tparam Inner The scaled expression.
+     */
+    template <Node Inner>
+    class Scaled final : public Expression<Scaled<Inner>> {
+    public:
+        using value_type = typename Inner::value_type;
+
+        Scaled(value_type scalar, const Inner& inner) noexcept
+            : m_scalar {scalar}, m_inner {inner} {}
+
+        [[nodiscard]] int rows() const noexcept { return m_inner.rows(); }
+        [[nodiscard]] int cols() const noexcept { return m_inner.cols(); }
+        [[nodiscard]] value_type operator[](std::size_t index) const noexcept { return m_scalar * m_inner[index]; }
+    private:
+        /**
+         * @brief The scalar factor.
+         */
+        value_type m_scalar;
+
+        /**
+         * @brief The scaled expression.
+         */
+        Inner m_inner;
+    };
+
+    /**
+     * @brief Element-wise addition.
+     */
+    struct Add {
+        template <typename T>
+        [[nodiscard]] static T apply(T lhs, T rhs) noexcept { return lhs + rhs; }
+    };
+
+    /**
+     * @brief Element-wise subtraction.
+     */
+    struct Sub {
+        template <typename T>
+        [[nodiscard]] static T apply(T lhs, T rhs) noexcept { return lhs - rhs; }
+    };
+
+    /**
+     * @brief Element-wise multiplication (Hadamard product).
+     */
+    struct Mul {
+        template <typename T>
+        [[nodiscard]] static T apply(T lhs, T rhs) noexcept { return lhs * rhs; }
+    };
+
+    /**
+     * @class Binary
+     * @brief Expression combining two expressions of the same shape element by element.
+     * @tparam Op The element-wise operation (Add, Sub or Mul).
+     * @tparam Lhs The left-hand side expression.
+     * @tparam Rhs The right-hand side expression.
+     */
+    template <typename Op, Node Lhs, Node Rhs>
+        requires std::same_as<typename Lhs::value_type, typename Rhs::value_type>
+    class Binary final : public Expression<Binary<Op, Lhs, Rhs>> {
+    public:
+        using value_type = typename Lhs::value_type;
+
+        /**
+         * @brief Combines two expressions.
+         * @throws std::invalid_argument if the dimensions do not match.
+         */
+        Binary(const Lhs& lhs, const Rhs& rhs)
+            : m_lhs {lhs}, m_rhs {rhs}
+        {
+            if (lhs.rows() != rhs.rows() || lhs.cols() != rhs.cols()) {
+                throw std::invalid_argument(std::format(
+                    "mismatched matrix dimensions ({}x{}) must be ({}x{})",
+                    rhs.rows(), rhs.cols(), lhs.rows(), lhs.cols()
+                ));
+            }
+        }
+
+        [[nodiscard]] int rows() const noexcept { return m_lhs.rows(); }
+        [[nodiscard]] int cols() const noexcept { return m_lhs.cols(); }
+        [[nodiscard]] value_type operator[](std::size_t index) const noexcept { return Op::apply(m_lhs[index], m_rhs[index]); }
+    private:
+        /**
+         * @brief The left-hand side expression.
+         */
+        Lhs m_lhs;
+
+        /**
+         * @brief The right-hand side expression.
+         */
+        Rhs m_rhs;
+    };
+
+    /**
+     * @brief Turns an operand into an expression: matrices become leaves, expressions are kept as they are.
+     * @param operand The operand to convert.
+     * @return Expression reading the operand.
+     */
+    template <Operand T>
+    [[nodiscard]] auto node(const T& operand) noexcept {
+        if constexpr (is_matrix<T>) {
+            return Leaf<value_t<T>> { operand };
+        } else {
+            return operand;
+        }
+    }
+
+    /**
+     * @brief Evaluates an expression into a buffer, combining each element with the value already there.
+     * @tparam Op Operation combining the current value with the expression (none = overwrite).
+     * @param expr The expression to evaluate.
+     * @param dst Buffer of rows() * cols() elements receiving the result.
+     * @note Every element only reads the same position of its operands, so dst may alias one of them.
+     */
+    template <typename Op = void, Node E>
+    void evaluate(const E& expr, typename E::value_type* dst) {
+        const std::size_t size = static_cast<std::size_t>(expr.rows()) * static_cast<std::size_t>(expr.cols());
+        parallel::for_each_chunk(size, parallel::GRAIN, [&](std::size_t first, std::size_t last) {
+            for (std::size_t index { first }; index < last; ++index) {
+                if constexpr (std::is_void_v<Op>) {
+                    dst[index] = expr[index];
+                } else {
+                    dst[index] = Op::apply(dst[index], expr[index]);
+                }
+            }
+        });
+    }
+}
+
+template <typename Derived>
+template <expression::Operand Rhs>
+inline auto expression::Expression<Derived>::hadamard(const Rhs& rhs) const {
+    return Binary<Mul, Derived, decltype(node(rhs))> { static_cast<const Derived&>(*this), node(rhs) };
+}
+
+/**
+ * @brief Adds two matrices or expressions element-wise, lazily.
+ * @param lhs The left-hand side operand.
+ * @param rhs The right-hand side operand.
+ * @return Expression of the sum, evaluated when assigned to a Matrix.
+ * @throws std::invalid_argument if the dimensions do not match.
+ */
+template <expression::Operand Lhs, expression::Operand Rhs>
+    requires std::same_as<expression::value_t<Lhs>, expression::value_t<Rhs>>
+[[nodiscard]] inline auto operator+(const Lhs& lhs, const Rhs& rhs) {
+    using namespace expression;
+    return Binary<Add, decltype(node(lhs)), decltype(node(rhs))> { node(lhs), node(rhs) };
+}
+
+/**
+ * @brief Subtracts two matrices or expressions element-wise, lazily.
+ * @param lhs The left-hand side operand.
+ * @param rhs The right-hand side operand.
+ * @return Expression of the difference, evaluated when assigned to a Matrix.
+ * @throws std::invalid_argument if the dimensions do not match.
+ */
+template <expression::Operand Lhs, expression::Operand Rhs>
+    requires std::same_as<expression::value_t<Lhs>, expression::value_t<Rhs>>
+[[nodiscard]] inline auto operator-(const Lhs& lhs, const Rhs& rhs) {
+    using namespace expression;
+    return Binary<Sub, decltype(node(lhs)), decltype(node(rhs))> { node(lhs), node(rhs) };
+}
+
+/**
+ * @brief Multiplies a matrix or expression by a scalar, lazily.
+ * @param operand The operand to multiply.
+ * @param scalar The scalar to multiply by.
+ * @return Expression of the scaled operand, evaluated when assigned to a Matrix.
+ */
+template <expression::Operand T>
+[[nodiscard]] inline auto operator*(const T& operand, expression::value_t<T> scalar) noexcept {
+    using namespace expression;
+    return Scaled<decltype(node(operand))> { scalar, node(operand) };
+}
+
+/**
+ * @brief Multiplies a scalar by a matrix or expression, lazily.
+ * @param scalar The scalar to multiply by, converted to the element type of the operand.
+ * @param operand The operand to multiply.
+ * @return Expression of the scaled operand, evaluated when assigned to a Matrix.
+ */
+template <expression::Operand T>
+[[nodiscard]] inline auto operator*(expression::value_t<T> scalar, const T& operand) noexcept {
+    return operand * scalar;
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "Matrix.h"
+#include "MatrixView.h"
+#include "Pool.h"
+#include <array>
+#include <format>
+#include <stdexcept>
+
+/**
+ * @class FixedMatrix
+ * @brief Matrix whose shape is a compile-time constant, stored inline.
+ * @details The elements live inside the object (row-major, aligned to pool::ALIGNMENT), so a
+ * FixedMatrix on the stack never allocates. Every loop bound is a template parameter: the
+ * kernels are unrolled by the compiler and shape mismatches are compile errors, so none of the
+ * runtime dimension checks of Matrix are needed. The only runtime check is at the boundary,
+ * when a FixedMatrix is built from a dynamically shaped view.
+ * @tparam T Element type.
+ * @tparam R Number of rows.
+ * @tparam C Number of columns.
+ * @note The storage is inline: large shapes (such as a 64x784 weight matrix) belong in
+ * heap-allocated objects rather than on the stack.
+ */
+template <typename T, int R, int C>
+class FixedMatrix {
+    static_assert(R > 0 && C > 0, "FixedMatrix dimensions must be positive");
+public:
+    /**
+     * @brief Type of the elements.
+     */
+    using value_type = T;
+
+    /**
+     * @brief Constructs a matrix filled with zeros.
+     */
+    constexpr FixedMatrix() = default;
+
+    /**
+     * @brief Copies a dynamically shaped view into a fixed matrix.
+     * @param view The view to copy, which must be (R x C).
+     * @return A new FixedMatrix holding the elements of the view.
+     * @throws std::invalid_argument if the shape of the view is not (R x C).
+     */
+    [[nodiscard]] static FixedMatrix from(const MatrixView<T>& view) {
+        if (view.rows() != R || view.cols() != C) {
+            throw std::invalid_argument(std::format(
+                "mismatched matrix dimensions ({}x{}) must be ({}x{})",
+                view.rows(), view.cols(), R, C
+            ));
+        }
+        FixedMatrix matrix;
+        for (int row { 0 }; row < R; ++row) {
+            for (int col { 0 }; col < C; ++col) {
+                matrix[row, col] = view[row, col];
+            }
+        }
+        return matrix;
+    }
+
+    /**
+     * @brief Returns the number of rows.
+     * @return Number of rows.
+     */
+    [[nodiscard]] static constexpr int rows() noexcept { return R; }
+
+    /**
+     * @brief Returns the number of columns.
+     * @return Number of columns.
+     */
+    [[nodiscard]] static constexpr int cols() noexcept { return C; }
+
+    /**
+     * @brief Accesses an element at the specified row and column indices.
+     * @param row Row index.
+     * @param col Column index.
+     * @return Reference to the element at the specified position.
+     * @note This method does not perform bounds checking.
+     */
+    [[nodiscard]] constexpr T& operator[](int row, int col) noexcept { return m_data[row * C + col]; }
+
+    /**
+     * @brief Accesses an element at the specified row and column indices.
+     * @param row Row index.
+     * @param col Column index.
+     * @return Const reference to the element at the specified position.
+     * @note This method does not perform bounds checking.
+     */
+    [[nodiscard]] constexpr const T& operator[](int row, int col) const noexcept { return m_data[row * C + col]; }
+
+    /**
+     * @brief Returns a pointer to the element at (0, 0).
+     * @return Pointer to the first element.
+     */
+    [[nodiscard]] constexpr T* data() noexcept { return m_data.data(); }
+
+    /**
+     * @brief Returns a pointer to the element at (0, 0).
+     * @return Pointer to the first element.
+     */
+    [[nodiscard]] constexpr const T* data() const noexcept { return m_data.data(); }
+
+    /**
+     * @brief Returns a view over all the elements, for use with the dynamically shaped functions.
+     * @return View of the matrix.
+     */
+    [[nodiscard]] MatrixView<T> view() const noexcept { return { m_data.data(), R, C, C, 1 }; }
+
+    /**
+     * @brief Copies the matrix into a dynamically shaped Matrix.
+     * @return A new Matrix holding the same elements.
+     */
+    [[nodiscard]] Matrix<T> to_matrix() const { return Matrix<T> { view() }; }
+
+    /**
+     * @brief Transposes the matrix.
+     * @return A new FixedMatrix that is the transpose of this matrix.
+     */
+    [[nodiscard]] constexpr FixedMatrix<T, C, R> transpose() const noexcept {
+        FixedMatrix<T, C, R> transposed;
+        for (int row { 0 }; row < R; ++row) {
+            for (int col { 0 }; col < C; ++col) {
+                transposed[col, row] = (*this)[row, col];
+            }
+        }
+        return transposed;
+    }
+
+    /**
+     * @brief Adds another matrix of the same shape to this matrix.
+     * @param matrix The matrix to add.
+     * @return Reference to this matrix.
+     */
+    constexpr FixedMatrix& operator+=(const FixedMatrix& matrix) noexcept {
+        for (int i { 0 }; i < R * C; ++i) {
+            m_data[i] += matrix.m_data[i];
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Subtracts another matrix of the same shape from this matrix.
+     * @param matrix The matrix to subtract.
+     * @return Reference to this matrix.
+     */
+    constexpr FixedMatrix& operator-=(const FixedMatrix& matrix) noexcept {
+        for (int i { 0 }; i < R * C; ++i) {
+            m_data[i] -= matrix.m_data[i];
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Applies a function to every element in place.
+     * @param function The function to apply.
+     * @return Reference to this matrix.
+     */
+    template <typename Function>
+    constexpr FixedMatrix& apply(Function&& function) noexcept {
+        for (T& value : m_data) {
+            value = function(value);
+        }
+        return *this;
+    }
+
+    friend constexpr bool operator==(const FixedMatrix& lhs, const FixedMatrix& rhs) noexcept {
+        return lhs.m_data == rhs.m_data;
+    }
+private:
+    /**
+     * @brief Row-major elements of the matrix.
+     */
+    alignas(pool::ALIGNMENT) std::array<T, static_cast<std::size_t>(R) * C> m_data {};
+};
+
+/**
+ * @brief Multiplies two fixed matrices; the inner dimensions are checked at compile time.
+ * @param lhs The left-hand side matrix (M x K).
+ * @param rhs The right-hand side matrix (K x N).
+ * @return A new FixedMatrix (M x N) containing the product.
+ * @note i-k-j order: the innermost loop runs over a row of rhs and of the product, whose
+ * constant length lets the compiler vectorize and unroll it completely for small N.
+ */
+template <typename T, int M, int K, int N>
+[[nodiscard]] constexpr FixedMatrix<T, M, N> operator*(const FixedMatrix<T, M, K>& lhs, const FixedMatrix<T, K, N>& rhs) noexcept {
+    FixedMatrix<T, M, N> product;
+    for (int i { 0 }; i < M; ++i) {
+        for (int k { 0 }; k < K; ++k) {
+            const T aik = lhs[i, k];
+            #pragma GCC unroll 16
+            for (int j { 0 }; j < N; ++j) {
+                product[i, j] += aik * rhs[k, j];
+            }
+        }
+    }
+    return product;
+}
+
+/**
+ * @brief Multiplies the transpose of a fixed matrix by another (lhs^T * rhs) without building the transpose.
+ * @param lhs The left-hand side matrix (K x M), read as its transpose.
+ * @param rhs The right-hand side matrix (K x N).
+ * @return A new FixedMatrix (M x N) containing the product.
+ * @note The rows of lhs are streamed once: with lhs holding the transposed weights of a layer,
+ * each row is the contribution of one input feature. A single column (N = 1) is accumulated as
+ * a vectorized M-long sum; wider batches apply one rank-1 update of the product per row.
+ */
+template <typename T, int K, int M, int N>
+[[nodiscard]] constexpr FixedMatrix<T, M, N> multiply_transposed(const FixedMatrix<T, K, M>& lhs, const FixedMatrix<T, K, N>& rhs) noexcept {
+    FixedMatrix<T, M, N> product;
+    for (int k { 0 }; k < K; ++k) {
+        const T* row = lhs.data() + k * M;
+        if constexpr (N == 1) {
+            const T bk = rhs[k, 0];
+            T* column = product.data();
+            #pragma GCC unroll 16
+            for (int i { 0 }; i < M; ++i) {
+                column[i] += row[i] * bk;
+            }
+        } else {
+            const T* b = rhs.data() + k * N;
+            for (int i { 0 }; i < M; ++i) {
+                const T aki = row[i];
+                T* out = product.data() + i * N;
+                #pragma GCC unroll 16
+                for (int j { 0 }; j < N; ++j) {
+                    out[j] += aki * b[j];
+                }
+            }
+        }
+    }
+    return product;
+}
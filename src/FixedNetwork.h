@@ -0,0 +1,243 @@
+#pragma once
+
+#include "Activation.h"
+#include "FixedMatrix.h"
+#include "NeuralNetwork.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+/**
+ * @class FixedLayer
+ * @brief Inference-only layer whose input and output widths are compile-time constants.
+ * @tparam T Element type.
+ * @tparam Input Number of input features.
+ * @tparam Output Number of output features.
+ */
+template <typename T, int Input, int Output>
+class FixedLayer {
+public:
+    /**
+     * @brief Constructs a layer with zero weights and biases and a ReLU activation.
+     */
+    FixedLayer() = default;
+
+    /**
+     * @brief Copies the weights, biases and activation of a trained layer.
+     * @param weights The (Output x Input) weight matrix.
+     * @param biases The (Output x 1) bias vector.
+     * @param activation Activation function type.
+     * @throws std::invalid_argument if the shapes do not match the layer or the activation type is unknown.
+     */
+    FixedLayer(const MatrixView<T>& weights, const MatrixView<T>& biases, activation::Type activation)
+        : w_t {FixedMatrix<T, Input, Output>::from(weights.transpose())}
+        , b {FixedMatrix<T, Output, 1>::from(biases)}
+        , activation {activation}
+    {
+        if (activation != activation::Type::ReLU && activation != activation::Type::Sigmoid && activation != activation::Type::Softmax) {
+            throw std::invalid_argument("unknown activation type");
+        }
+    }
+
+    /**
+     * @brief Predicts the output for a batch of B samples, one per column.
+     * @param a_prev Input batch (Input x B).
+     * @return Output batch (Output x B) after applying the activation function.
+     */
+    template <int B>
+    [[nodiscard]] FixedMatrix<T, Output, B> predict(const FixedMatrix<T, Input, B>& a_prev) const noexcept {
+        FixedMatrix<T, Output, B> z = multiply_transposed(w_t, a_prev);
+        for (int row { 0 }; row < Output; ++row) {
+            for (int col { 0 }; col < B; ++col) {
+                z[row, col] += b[row, 0];
+            }
+        }
+        switch (activation) {
+            case activation::Type::ReLU:
+                z.apply(activation::ReLU<T>);
+                break;
+            case activation::Type::Sigmoid:
+                z.apply(activation::sigmoid<T>);
+                break;
+            default:
+                softmax(z);
+                break;
+        }
+        return z;
+    }
+private:
+    /**
+     * @brief Transposed weights (Input x Output), so the product streams them row by row.
+     */
+    FixedMatrix<T, Input, Output> w_t;
+
+    /**
+     * @brief Bias vector for the layer.
+     */
+    FixedMatrix<T, Output, 1> b;
+
+    /**
+     * @brief Activation function used in the layer.
+     */
+    activation::Type activation = activation::Type::ReLU;
+
+    /**
+     * @brief Applies the softmax function to every column in place.
+     * @note The column maximum is subtracted first, so the sum of exponentials is at least one.
+     */
+    template <int B>
+    static void softmax(FixedMatrix<T, Output, B>& z) noexcept {
+        for (int col { 0 }; col < B; ++col) {
+            T col_max = z[0, col];
+            for (int row { 1 }; row < Output; ++row) {
+                col_max = std::max(col_max, z[row, col]);
+            }
+            T sum_exp { 0 };
+            for (int row { 0 }; row < Output; ++row) {
+                z[row, col] = std::exp(z[row, col] - col_max);
+                sum_exp += z[row, col];
+            }
+            const T inverse_sum = T { 1 } / sum_exp;
+            for (int row { 0 }; row < Output; ++row) {
+                z[row, col] *= inverse_sum;
+            }
+        }
+    }
+};
+
+/**
+ * @namespace fixed
+ * @brief Contains implementation details of FixedNetwork.
+ */
+namespace fixed {
+
+    /**
+     * @brief Builds the tuple of layers of a network from its list of widths.
+     */
+    template <typename T, typename Widths, typename Indices>
+    struct Layers;
+
+    template <typename T, int... Widths, std::size_t... I>
+    struct Layers<T, std::integer_sequence<int, Widths...>, std::index_sequence<I...>> {
+        static constexpr std::array<int, sizeof...(Widths)> widths { Widths... };
+        using type = std::tuple<FixedLayer<T, widths[I], widths[I + 1]>...>;
+    };
+}
+
+/**
+ * @class FixedNetwork
+ * @brief Inference-only copy of a trained network whose layer widths are template parameters.
+ * @details For the example network, FixedNetwork<float, 784, 64, 64, 10>. Every product and
+ * activation runs on FixedMatrix operands, so all loop bounds are compile-time constants and a
+ * batch of B samples goes through the network without allocating or checking shapes. The layer
+ * shapes of the trained network are checked once, when the fixed copy is built.
+ * @tparam T Element type.
+ * @tparam Widths Number of input features followed by the width of every layer.
+ * @note The weights are stored inline (about 200 KiB in float for the example network), so
+ * create networks with std::make_unique rather than on the stack.
+ */
+template <typename T, int... Widths>
+class FixedNetwork {
+    static_assert(sizeof...(Widths) >= 2, "FixedNetwork needs an input width and at least one layer");
+public:
+    /**
+     * @brief Number of layers.
+     */
+    static constexpr std::size_t depth = sizeof...(Widths) - 1;
+
+    /**
+     * @brief Number of input features.
+     */
+    static constexpr int input_size = std::get<0>(std::array { Widths... });
+
+    /**
+     * @brief Number of outputs of the last layer.
+     */
+    static constexpr int output_size = std::get<depth>(std::array { Widths... });
+
+    /**
+     * @brief Copies the weights, biases and activations of a trained network.
+     * @param network The trained network.
+     * @throws std::invalid_argument if the number of layers or any layer shape differs from Widths.
+     */
+    template <typename Master>
+    explicit FixedNetwork(const NeuralNetwork<T, Master>& network) {
+        const auto& trained = network.get_layers();
+        if (trained.size() != depth) {
+            throw std::invalid_argument(std::format(
+                "mismatched number of layers {} must be {}", trained.size(), depth
+            ));
+        }
+        copy_layers(trained, std::make_index_sequence<depth> {});
+    }
+
+    /**
+     * @brief Predicts the output for a batch of B samples, one per column.
+     * @param input Input batch (input_size x B).
+     * @return Output batch (output_size x B).
+     */
+    template <int B>
+    [[nodiscard]] FixedMatrix<T, output_size, B> predict(const FixedMatrix<T, input_size, B>& input) const noexcept {
+        return forward<0>(input);
+    }
+
+    /**
+     * @brief Predicts the output for a dynamically sized batch, one sample at a time.
+     * @param input The input data matrix (input_size x samples).
+     * @return The predicted output matrix (output_size x samples).
+     * @throws std::invalid_argument if input does not have input_size rows.
+     */
+    [[nodiscard]] Matrix<T> predict(const MatrixView<T>& input) const {
+        if (input.rows() != input_size) {
+            throw std::invalid_argument(std::format(
+                "mismatched input rows {} must be {}", input.rows(), input_size
+            ));
+        }
+        Matrix<T> output { output_size, input.cols() };
+        parallel::for_each_chunk(static_cast<std::size_t>(input.cols()), 16, [&](std::size_t first, std::size_t last) {
+            FixedMatrix<T, input_size, 1> sample;
+            for (int col { static_cast<int>(first) }; col < static_cast<int>(last); ++col) {
+                for (int row { 0 }; row < input_size; ++row) {
+                    sample[row, 0] = input[row, col];
+                }
+                const FixedMatrix<T, output_size, 1> prediction = predict(sample);
+                for (int row { 0 }; row < output_size; ++row) {
+                    output[row, col] = prediction[row, 0];
+                }
+            }
+        }, static_cast<std::size_t>(input.rows()) * static_cast<std::size_t>(input.cols()));
+        return output;
+    }
+private:
+    /**
+     * @brief Tuple of the layers, from input to output.
+     */
+    typename fixed::Layers<T, std::integer_sequence<int, Widths...>, std::make_index_sequence<depth>>::type layers;
+
+    /**
+     * @brief Copies every trained layer into the matching fixed layer.
+     */
+    template <typename Layer, std::size_t... I>
+    void copy_layers(const std::vector<Layer>& trained, std::index_sequence<I...>) {
+        ((std::get<I>(layers) = { trained[I].weights(), trained[I].biases(), trained[I].activation_type() }), ...);
+    }
+
+    /**
+     * @brief Forwards a batch from layer I to the output.
+     */
+    template <std::size_t I, int Rows, int B>
+    [[nodiscard]] FixedMatrix<T, output_size, B> forward(const FixedMatrix<T, Rows, B>& a) const noexcept {
+        const auto next = std::get<I>(layers).predict(a);
+        if constexpr (I + 1 == depth) {
+            return next;
+        } else {
+            return forward<I + 1>(next);
+        }
+    }
+};
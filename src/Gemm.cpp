@@ -0,0 +1,249 @@
+#include "Gemm.h"
+#include "Activation.h"
+#include "Pool.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Packs an mc x kc block of A into row panels of MR rows, zero-padding the last panel.
+ * @details Each panel is stored column by column, so the micro-kernel reads MR consecutive values per step.
+ * Element (i, p) of the block is read from a[i * rsa + p * csa].
+ */
+template <typename T>
+static void pack_a(int mc, int kc, const T* a, std::ptrdiff_t rsa, std::ptrdiff_t csa, T* packed) {
+    for (int ir { 0 }; ir < mc; ir += gemm::MR) {
+        const int rows = std::min(gemm::MR, mc - ir);
+        for (int p { 0 }; p < kc; ++p) {
+            for (int i { 0 }; i < rows; ++i) {
+                packed[i] = a[(ir + i) * rsa + p * csa];
+            }
+            for (int i { rows }; i < gemm::MR; ++i) {
+                packed[i] = T { 0 };
+            }
+            packed += gemm::MR;
+        }
+    }
+}
+
+/**
+ * @brief Packs a kc x nc panel of B into column panels of NR columns, zero-padding the last panel.
+ * @details Each panel is stored row by row, so the micro-kernel reads NR consecutive values per step.
+ * Element (p, j) of the panel is read from b[p * rsb + j * csb].
+ */
+template <typename T>
+static void pack_b(int kc, int nc, const T* b, std::ptrdiff_t rsb, std::ptrdiff_t csb, T* packed) {
+    for (int jr { 0 }; jr < nc; jr += gemm::NR) {
+        const int cols = std::min(gemm::NR, nc - jr);
+        for (int p { 0 }; p < kc; ++p) {
+            const T* row = b + p * rsb + jr * csb;
+            if (csb == 1) {
+                for (int j { 0 }; j < cols; ++j) {
+                    packed[j] = row[j];
+                }
+            } else {
+                for (int j { 0 }; j < cols; ++j) {
+                    packed[j] = row[j * csb];
+                }
+            }
+            for (int j { cols }; j < gemm::NR; ++j) {
+                packed[j] = T { 0 };
+            }
+            packed += gemm::NR;
+        }
+    }
+}
+
+/**
+ * @brief Applies an epilogue activation to a value.
+ */
+template <typename T>
+[[nodiscard]] static inline T activate(T value, gemm::Activation activation) noexcept {
+    switch (activation) {
+        case gemm::Activation::ReLU:
+            return activation::ReLU(value);
+        case gemm::Activation::Sigmoid:
+            return activation::sigmoid(value);
+        default:
+            return value;
+    }
+}
+
+/**
+ * @brief Moves an epilogue to the block of C starting at (row, col).
+ */
+template <typename T>
+[[nodiscard]] static gemm::Epilogue<T> offset(const gemm::Epilogue<T>& epilogue, std::ptrdiff_t row, std::ptrdiff_t col) noexcept {
+    return {
+        .bias = epilogue.bias ? epilogue.bias + row : nullptr,
+        .activation = epilogue.activation,
+        .out = epilogue.out ? epilogue.out + row * epilogue.ldo + col : nullptr,
+        .ldo = epilogue.ldo,
+    };
+}
+
+/**
+ * @brief Computes an MR x NR tile of C from one packed A panel and one packed B panel.
+ * @details The accumulators are 16-byte vector lanes with fully unrolled loops, so the whole
+ * tile stays in registers for the entire kc loop; only the valid mr x nr corner is written back.
+ * @param accumulate If true, the tile is added to C; otherwise C is overwritten.
+ * @param epilogue Epilogue moved to this tile, set only for the last k block.
+ */
+template <typename T>
+static void micro_kernel(
+    int kc, const T* a, const T* b,
+    T* c, int ldc, int mr, int nr, bool accumulate,
+    const gemm::Epilogue<T>* epilogue
+) {
+    typedef T lane __attribute__((vector_size(16)));
+    constexpr int LANES = gemm::NR * static_cast<int>(sizeof(T)) / 16;
+
+    lane acc[gemm::MR][LANES] {};
+    for (int p { 0 }; p < kc; ++p) {
+        lane bp[LANES];
+        __builtin_memcpy(bp, b, sizeof(bp));
+#pragma GCC unroll 16
+        for (int i { 0 }; i < gemm::MR; ++i) {
+            const T aip = a[i];
+#pragma GCC unroll 16
+            for (int j { 0 }; j < LANES; ++j) {
+                acc[i][j] += aip * bp[j];
+            }
+        }
+        a += gemm::MR;
+        b += gemm::NR;
+    }
+
+    T tile[gemm::MR][gemm::NR];
+    __builtin_memcpy(tile, acc, sizeof(tile));
+    for (int i { 0 }; i < mr; ++i) {
+        T* row = c + static_cast<std::ptrdiff_t>(i) * ldc;
+        if (accumulate) {
+            for (int j { 0 }; j < nr; ++j) {
+                tile[i][j] += row[j];
+            }
+        }
+        if (!epilogue) {
+            for (int j { 0 }; j < nr; ++j) {
+                row[j] = tile[i][j];
+            }
+            continue;
+        }
+        const T bias = epilogue->bias ? epilogue->bias[i] : T { 0 };
+        T* out = epilogue->out ? epilogue->out + static_cast<std::ptrdiff_t>(i) * epilogue->ldo : row;
+        for (int j { 0 }; j < nr; ++j) {
+            const T z = tile[i][j] + bias;
+            row[j] = z;
+            out[j] = activate(z, epilogue->activation);
+        }
+    }
+}
+
+/**
+ * @brief Runs the blocked multiplication on the calling thread.
+ */
+template <typename T>
+static void multiply_serial(
+    int m, int n, int k,
+    const T* a, std::ptrdiff_t rsa, std::ptrdiff_t csa,
+    const T* b, std::ptrdiff_t rsb, std::ptrdiff_t csb,
+    T* c, int ldc,
+    const gemm::Epilogue<T>& epilogue
+) {
+    using gemm::MR, gemm::NR, gemm::KC, gemm::MC, gemm::NC;
+    thread_local std::vector<T, pool::Allocator<T>> packed_a;
+    thread_local std::vector<T, pool::Allocator<T>> packed_b;
+    packed_a.resize(static_cast<size_t>(MC) * KC);
+    packed_b.resize(static_cast<size_t>(KC) * (NC + NR));
+    const bool fused = epilogue.bias || epilogue.out || epilogue.activation != gemm::Activation::None;
+
+    for (int jc { 0 }; jc < n; jc += NC) {
+        const int nc = std::min(NC, n - jc);
+
+        for (int pc { 0 }; pc < k; pc += KC) {
+            const int kc = std::min(KC, k - pc);
+            const bool accumulate = pc > 0;
+            const bool finish = fused && pc + kc >= k;
+            pack_b(kc, nc, b + pc * rsb + jc * csb, rsb, csb, packed_b.data());
+
+            for (int ic { 0 }; ic < m; ic += MC) {
+                const int mc = std::min(MC, m - ic);
+                pack_a(mc, kc, a + ic * rsa + pc * csa, rsa, csa, packed_a.data());
+
+                for (int jr { 0 }; jr < nc; jr += NR) {
+                    for (int ir { 0 }; ir < mc; ir += MR) {
+                        const gemm::Epilogue<T> tile = offset(epilogue, ic + ir, jc + jr);
+                        micro_kernel(
+                            kc,
+                            packed_a.data() + static_cast<std::ptrdiff_t>(ir) * kc,
+                            packed_b.data() + static_cast<std::ptrdiff_t>(jr) * kc,
+                            c + static_cast<std::ptrdiff_t>(ic + ir) * ldc + jc + jr, ldc,
+                            std::min(MR, mc - ir), std::min(NR, nc - jr),
+                            accumulate,
+                            finish ? &tile : nullptr
+                        );
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Writes the result of an empty product (k = 0): C holds the bias of each row, or zero,
+ * and the epilogue activation is applied as it would be to any finished tile.
+ */
+template <typename T>
+static void multiply_empty(int m, int n, T* c, int ldc, const gemm::Epilogue<T>& epilogue) {
+    for (int i { 0 }; i < m; ++i) {
+        T* row = c + static_cast<std::ptrdiff_t>(i) * ldc;
+        T* out = epilogue.out ? epilogue.out + static_cast<std::ptrdiff_t>(i) * epilogue.ldo : row;
+        const T z = epilogue.bias ? epilogue.bias[i] : T { 0 };
+        for (int j { 0 }; j < n; ++j) {
+            row[j] = z;
+            out[j] = activate(z, epilogue.activation);
+        }
+    }
+}
+
+template <typename T>
+void gemm::multiply(
+    Transpose ta, Transpose tb,
+    int m, int n, int k,
+    const T* a, int lda,
+    const T* b, int ldb,
+    T* c, int ldc,
+    const Epilogue<T>& epilogue
+) {
+    /* No k block is accumulated, so the blocked loops would never write C nor run the epilogue */
+    if (k <= 0) {
+        multiply_empty(m, n, c, ldc, epilogue);
+        return;
+    }
+
+    /* Transposition only swaps the strides used to walk each operand */
+    const std::ptrdiff_t rsa = ta == Transpose::No ? lda : 1;
+    const std::ptrdiff_t csa = ta == Transpose::No ? 1 : lda;
+    const std::ptrdiff_t rsb = tb == Transpose::No ? ldb : 1;
+    const std::ptrdiff_t csb = tb == Transpose::No ? 1 : ldb;
+    const std::size_t work = static_cast<std::size_t>(m) * static_cast<std::size_t>(n) * static_cast<std::size_t>(k);
+
+    /* Split the larger output dimension so every thread owns a disjoint block of C */
+    if (n >= m) {
+        parallel::for_each_chunk(static_cast<std::size_t>(n), NR, [&](std::size_t first, std::size_t last) {
+            const std::ptrdiff_t col = static_cast<std::ptrdiff_t>(first);
+            multiply_serial(m, static_cast<int>(last - first), k,
+                a, rsa, csa, b + col * csb, rsb, csb, c + col, ldc, offset(epilogue, 0, col));
+        }, work);
+    } else {
+        parallel::for_each_chunk(static_cast<std::size_t>(m), MR, [&](std::size_t first, std::size_t last) {
+            const std::ptrdiff_t row = static_cast<std::ptrdiff_t>(first);
+            multiply_serial(static_cast<int>(last - first), n, k,
+                a + row * rsa, rsa, csa, b, rsb, csb, c + row * ldc, ldc, offset(epilogue, row, 0));
+        }, work);
+    }
+}
+
+template void gemm::multiply<float>(Transpose, Transpose, int, int, int, const float*, int, const float*, int, float*, int, const Epilogue<float>&);
+template void gemm::multiply<double>(Transpose, Transpose, int, int, int, const double*, int, const double*, int, double*, int, const Epilogue<double>&);
@@ -0,0 +1,79 @@
+#pragma once
+
+/**
+ * @namespace gemm
+ * @brief Contains the blocked general matrix multiplication engine behind Matrix::matmul.
+ * @details The engine follows the usual packed-panel structure: B is packed into
+ * KC x NC panels that stay in L2/L3, A is packed into MC x KC blocks that stay in L2,
+ * and a register-tiled MR x NR micro-kernel streams both packed buffers from L1.
+ * The engine is instantiated for float and double.
+ */
+namespace gemm {
+
+    inline constexpr int MR = 4;        ///< Rows of the register tile computed by the micro-kernel
+    inline constexpr int NR = 4;        ///< Columns of the register tile computed by the micro-kernel
+    inline constexpr int KC = 256;      ///< Depth of the packed panels (sized for L1)
+    inline constexpr int MC = 128;      ///< Rows of the packed A block (sized for L2)
+    inline constexpr int NC = 4096;     ///< Columns of the packed B panel (sized for L3)
+
+    /**
+     * @enum Transpose
+     * @brief Enum representing whether an operand is read as stored or transposed.
+     */
+    enum class Transpose {
+        No,     ///< Operand is used as stored
+        Yes     ///< Operand is used transposed, reading the storage in place
+    };
+
+    /**
+     * @enum Activation
+     * @brief Enum representing the element-wise function an epilogue applies to the finished tiles.
+     */
+    enum class Activation {
+        None,       ///< Identity
+        ReLU,       ///< Rectified Linear Unit
+        Sigmoid     ///< Sigmoid
+    };
+
+    /**
+     * @struct Epilogue
+     * @brief Work applied to every tile of C once its last k block is accumulated, before the tile leaves the micro-kernel.
+     * @details C receives op(A) * op(B) plus the bias of its row. If out is set, the activation of that
+     * value is written to out as well; otherwise the activation replaces the value in C.
+     */
+    template <typename T>
+    struct Epilogue {
+        const T* bias = nullptr;                    ///< One value per row of C, added to every element of that row (nullptr = none)
+        Activation activation = Activation::None;   ///< Function applied after the bias
+        T* out = nullptr;                           ///< Destination of the activation, with the shape of C (nullptr = C itself)
+        int ldo = 0;                                ///< Distance between consecutive rows of out
+    };
+
+    /**
+     * @brief Computes the product C = op(A) * op(B) of row-major operands.
+     * @param ta Whether A is transposed.
+     * @param tb Whether B is transposed.
+     * @param m Number of rows of op(A) and C.
+     * @param n Number of columns of op(B) and C.
+     * @param k Number of columns of op(A) and rows of op(B).
+     * @param a Pointer to the first element of A.
+     * @param lda Distance between consecutive rows of A as stored.
+     * @param b Pointer to the first element of B.
+     * @param ldb Distance between consecutive rows of B as stored.
+     * @param c Pointer to the first element of C.
+     * @param ldc Distance between consecutive rows of C.
+     * @param epilogue Bias and activation applied to the finished tiles (default = none).
+     * @note C is overwritten, so it does not need to be zero-initialized. When k is 0, C is filled
+     * with the bias of each row (or zero) and the epilogue activation is still applied.
+     * @note Transposed operands are handled while packing, so no transposed copy is made.
+     */
+    template <typename T>
+    void multiply(
+        Transpose ta, Transpose tb,
+        int m, int n, int k,
+        const T* a, int lda,
+        const T* b, int ldb,
+        T* c, int ldc,
+        const Epilogue<T>& epilogue = {}
+    );
+}
@@ -1,14 +1,15 @@
 #include "Initialization.h"
 #include <stdexcept>
 
-Matrix initialization::init(int rows, int cols, initialization::Type type, std::mt19937& gen) {
+template <typename T>
+Matrix<T> initialization::init(int rows, int cols, initialization::Type type, std::mt19937& gen) {
     const double fan_in  = static_cast<double>(cols);
     const double fan_out = static_cast<double>(rows);
     
     switch (type) {
         case Type::LeCun: {
             const double limit = std::sqrt(3.0 / fan_in);
-            return detail::random(
+            return detail::random<T>(
                 rows, cols, 
                 std::uniform_real_distribution(-limit, limit),
                 gen
@@ -16,7 +17,7 @@ Matrix initialization::init(int rows, int cols, initialization::Type type, std::
         }
         case Type::Glorot: {
             const double limit = std::sqrt(6.0 / (fan_in + fan_out));
-            return detail::random(
+            return detail::random<T>(
                 rows, cols, 
                 std::uniform_real_distribution(-limit, limit),
                 gen
@@ -24,7 +25,7 @@ Matrix initialization::init(int rows, int cols, initialization::Type type, std::
         }
         case Type::He: {
             const double stddev = std::sqrt(2.0 / fan_in);
-            return detail::random(
+            return detail::random<T>(
                 rows, cols, 
                 std::normal_distribution(0.0, stddev),
                 gen
@@ -35,9 +36,12 @@ Matrix initialization::init(int rows, int cols, initialization::Type type, std::
     }
 }
 
-template <typename Distribution>
-Matrix initialization::detail::random(int rows, int cols, Distribution&& dist, std::mt19937 &gen) {
-    std::vector<double> data(static_cast<std::size_t>(rows * cols));
-    std::generate(data.begin(), data.end(), [&] { return dist(gen); });
-    return Matrix(rows, cols, std::move(data));
+template <typename T, typename Distribution>
+Matrix<T> initialization::detail::random(int rows, int cols, Distribution&& dist, std::mt19937 &gen) {
+    typename Matrix<T>::Storage data(static_cast<std::size_t>(rows * cols));
+    std::generate(data.begin(), data.end(), [&] { return static_cast<T>(dist(gen)); });
+    return Matrix<T>(rows, cols, std::move(data));
 }
+
+template Matrix<float> initialization::init(int, int, initialization::Type, std::mt19937&);
+template Matrix<double> initialization::init(int, int, initialization::Type, std::mt19937&);
@@ -28,7 +28,8 @@ namespace initialization {
      * @return A new Matrix initialized with random values.
      * @throws std::invalid_argument if an unknown initialization type is specified.
      */
-    [[nodiscard]] Matrix init(
+    template <typename T>
+    [[nodiscard]] Matrix<T> init(
         int rows, int cols, 
         initialization::Type type, 
         std::mt19937& gen
@@ -47,8 +48,8 @@ namespace initialization {
          * @param gen Random number generator to use for generating random values.
          * @return A new Matrix initialized with random values.
          */
-        template <typename Distribution>
-        [[nodiscard]] Matrix random(int rows, int cols, 
+        template <typename T, typename Distribution>
+        [[nodiscard]] Matrix<T> random(int rows, int cols, 
             Distribution&& dist, 
             std::mt19937 &gen
         );
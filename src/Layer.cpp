@@ -1,67 +1,96 @@
 #include "Layer.h"
 #include <stdexcept>
 
-Matrix Layer::predict(const Matrix& a_prev) const {
-    return activation::apply(broadcast_col_add(w * a_prev, b), activation);
+template <typename T>
+Matrix<T> Layer<T>::predict(const MatrixView<T>& a_prev) const {
+    Matrix<T> out { w.rows(), a_prev.cols() };
+    predict_into(out, a_prev);
+    return out;
 }
 
-Matrix Layer::forward(const Matrix& a_prev) {
+template <typename T>
+void Layer<T>::predict_into(Matrix<T>& out, const MatrixView<T>& a_prev) const {
+    activation::linear_into(out, out, w, a_prev, b, activation);
+}
+
+template <typename T>
+const Matrix<T>& Layer<T>::forward(const MatrixView<T>& a_prev) {
     cached_input = a_prev;
-    z = broadcast_col_add(w * a_prev, b);
-    return activation::apply(z, activation);
+    cached_sparse_input = nullptr;
+    activation::linear_into(z, a, w, a_prev, b, activation);
+    return a;
 }
 
-Matrix Layer::backward(const Matrix& gradient) {
-    Matrix delta = gradient
-        .hadamard(activation::apply_prime(z, activation));
-    
-    const int batch_size = cached_input.cols();
-    dw = (delta * cached_input.transpose()) / batch_size;
-    db = delta.row_avg();
+template <typename T>
+const Matrix<T>& Layer<T>::forward(const SparseMatrix<T>& a_prev) {
+    cached_input = {};
+    cached_sparse_input = &a_prev;
+    matmul_into(z, w, a_prev);
+    activation::bias_apply_into(z, a, b, activation);
+    return a;
+}
+
+template <typename T>
+const Matrix<T>& Layer<T>::forward_logits(const MatrixView<T>& a_prev) {
+    cached_input = a_prev;
+    cached_sparse_input = nullptr;
+    matmul_into(z, z, w, a_prev, b, gemm::Activation::None);
+    return z;
+}
 
-    return w.transpose() * delta;
+template <typename T>
+const Matrix<T>& Layer<T>::forward_logits(const SparseMatrix<T>& a_prev) {
+    static_cast<void>(forward(a_prev));
+    return z;
 }
 
-std::pair<Matrix, double> Layer::loss(const Matrix& label, const Matrix& prediction, loss::Type loss) {
+template <typename T>
+const Matrix<T>& Layer<T>::backward(const MatrixView<T>& gradient) {
+    activation::apply_prime_into(delta, z, activation);
+    hadamard_into(delta, delta, gradient);
+    return backpropagate_delta();
+}
+
+template <typename T>
+std::pair<const Matrix<T>&, double> Layer<T>::loss(const MatrixView<T>& label, const MatrixView<T>& prediction, loss::Type loss) {
     double loss_metric = loss::compute(label, prediction, loss);
 
-    Matrix delta = loss::gradient(label, 
+    loss::gradient_into(delta,
+        label, 
         prediction, 
         z,
         loss,
         activation
     );
     
-    const double batch_size = cached_input.cols();
-    dw = (delta * cached_input.transpose()) / batch_size;
-    db = delta.row_avg();
-    
-    return {w.transpose() * delta, loss_metric};
+    return {backpropagate_delta(), loss_metric};
 }
 
-void Layer::update(double learning_rate, 
-    const regularization::Settings& regularization,
-    double weight_decay
-) {
-    const Matrix reg_term = regularization::term(w, regularization);
-    if (weight_decay > 0.0) {
-        w -= learning_rate * weight_decay * w;
+template <typename T>
+std::pair<const Matrix<T>&, double> Layer<T>::loss(std::span<const int> labels) {
+    if (activation != activation::Type::Softmax) {
+        throw std::logic_error("fused cross entropy loss requires a softmax output layer");
     }
-    optimizer_w->update(w, dw + reg_term, learning_rate);
-    optimizer_b->update(b, db, learning_rate);
+    double loss_metric = loss::softmax_cross_entropy_into(delta, z, labels);
+    return {backpropagate_delta(), loss_metric};
 }
 
-Matrix Layer::broadcast_col_add(const Matrix& matrix, const Matrix& column) const {
-    if (column.rows() != matrix.rows() || column.cols() != 1) {
-        throw std::invalid_argument("broadcast column add input size mismatch");
-    }
-    Matrix result = matrix;
-    for (int row = 0; row < result.rows(); ++row) {
-        const double b = column[row, 0];
-        for (int col = 0; col < result.cols(); ++col) {
-            result[row, col] += b;
-        }
+template <typename T>
+const Matrix<T>& Layer<T>::backpropagate_delta() {
+    const int batch_size = delta.cols();
+    if (cached_sparse_input) {
+        matmul_nt_into(dw, delta, *cached_sparse_input);
+    } else {
+        matmul_into(dw, delta, cached_input.transpose());
     }
+    dw /= batch_size;
+    row_avg_into(db, delta);
 
-    return result;
+    if (input_gradient) {
+        matmul_into(da_prev, w.view().transpose(), delta);
+    }
+    return da_prev;
 }
+
+template class Layer<float>;
+template class Layer<double>;
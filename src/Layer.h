@@ -3,15 +3,19 @@
 #include "Activation.h"
 #include "Initialization.h"
 #include "Loss.h"
-#include "Optimizer.h"
-#include "Regularization.h"
-#include <memory>
+#include "Parameters.h"
+#include "SparseMatrix.h"
 #include <random>
+#include <span>
 
 /**
  * @class Layer
  * @brief Represents a single layer in a neural network.
+ * @tparam T Element type of the forward and backward passes.
+ * @details The weights, the biases and their gradients are drawn from the flat buffers of a
+ * Parameters object, which updates them for every layer at once.
  */
+template <typename T>
 class Layer {
 public:
     /**
@@ -20,41 +24,102 @@ public:
      * @param output Number of output features.
      * @param activation Activation function type.
      * @param initialization Weight initialization type.
-     * @param optimizer Optimizer settings for weight and bias updates.
+     * @param slots Allocators of the flat buffers the weights, biases and gradients are drawn from.
      * @param gen Random number generator for weight initialization.
      */
     Layer(
         int input, int output, 
         activation::Type activation, 
         initialization::Type initialization,
-        const optimizer::Settings& optimizer, 
+        const parameters::Slots<T>& slots, 
         std::mt19937& gen
     )
         : activation {activation}
-        , w(initialization::init(output, input, initialization, gen))
-        , b(output, 1, 0.0)
+        , w(output, input, slots.weights)
+        , b(output, 1, slots.biases)
         , z(output, 1)
-        , cached_input(input, 1)
-        , dw(output, input)
-        , db(output, 1)
+        , a(output, 1)
+        , delta(output, 1)
+        , da_prev(input, 1)
+        , dw(output, input, slots.weight_gradients)
+        , db(output, 1, slots.bias_gradients)
     {
-        optimizer_w = optimizer::create(output, input, optimizer);
-        optimizer_b = optimizer::create(output, 1, optimizer);
+        w.assign(initialization::init<T>(output, input, initialization, gen));
     }
 
+    /**
+     * @brief Constructs a layer with the shape and settings of another, drawing zero-filled matrices from new buffers.
+     * @param other The layer to take the shape and settings from.
+     * @param slots Allocators of the flat buffers, into which the values of other are then copied in one pass.
+     */
+    Layer(const Layer& other, const parameters::Slots<T>& slots)
+        : activation {other.activation}
+        , w(other.w.rows(), other.w.cols(), slots.weights)
+        , b(other.b.rows(), 1, slots.biases)
+        , z(other.z.rows(), 1)
+        , a(other.a.rows(), 1)
+        , delta(other.delta.rows(), 1)
+        , da_prev(other.da_prev.rows(), 1)
+        , input_gradient {other.input_gradient}
+        , dw(other.dw.rows(), other.dw.cols(), slots.weight_gradients)
+        , db(other.db.rows(), 1, slots.bias_gradients)
+    {}
+
+    /**
+     * @brief Deleted copy constructor: a copy must draw its matrices from the buffers of its own network.
+     */
+    Layer(const Layer&) = delete;
+
+    /**
+     * @brief Move constructor; the matrices keep pointing into the same buffers.
+     */
+    Layer(Layer&&) noexcept = default;
+
+    Layer& operator=(const Layer&) = delete;
+    Layer& operator=(Layer&&) = delete;
+
     /**
      * @brief Forwards the input through the layer.
      * @param a_prev Input matrix from the previous layer.
      * @return Output matrix after applying the activation function.
+     * @note Only a view of a_prev is cached, so it must stay alive until backward or loss is called.
+     * The returned matrix is owned by the layer and overwritten by the next forward call.
      */
-    [[nodiscard]] Matrix forward(const Matrix& a_prev);
+    [[nodiscard]] const Matrix<T>& forward(const MatrixView<T>& a_prev);
+
+    /**
+     * @brief Forwards a sparse input through the layer, skipping its zero elements.
+     * @param a_prev Sparse input matrix, typically a batch of raw samples for the first layer.
+     * @return Output matrix after applying the activation function.
+     * @note Only a pointer to a_prev is cached, so it must stay alive until backward or loss is called;
+     * the weight gradient is then computed from the sparse input as well.
+     */
+    [[nodiscard]] const Matrix<T>& forward(const SparseMatrix<T>& a_prev);
+
+    /**
+     * @brief Forwards the input through the layer up to its linear output, leaving the activation to a fused loss.
+     * @param a_prev Input matrix from the previous layer.
+     * @return Linear output (logits) of the layer.
+     * @note Caches its input like forward; the returned matrix is owned by the layer.
+     */
+    [[nodiscard]] const Matrix<T>& forward_logits(const MatrixView<T>& a_prev);
+
+    /**
+     * @brief Forwards a sparse input through the layer up to its linear output.
+     * @param a_prev Sparse input matrix.
+     * @return Linear output (logits) of the layer.
+     * @note The sparse product has no epilogue to skip, so the activations are computed as well.
+     */
+    [[nodiscard]] const Matrix<T>& forward_logits(const SparseMatrix<T>& a_prev);
 
     /**
      * @brief Backwards the gradient through the layer.
      * @param gradient Gradient matrix from the next layer.
      * @return Gradient matrix for the previous layer.
+     * @note The returned matrix is owned by the layer and overwritten by the next backward or loss call.
+     * It is left untouched when the input gradient is disabled with set_input_gradient.
      */
-    [[nodiscard]] Matrix backward(const Matrix& gradient);
+    [[nodiscard]] const Matrix<T>& backward(const MatrixView<T>& gradient);
     
     /**
      * @brief Computes the loss and its gradient for the layer.
@@ -62,24 +127,64 @@ public:
      * @param prediction Predicted output from the layer.
      * @param loss Type of loss function to use.
      * @return Pair containing the gradient for the previous layer and the computed loss value.
-     * @note This function should be used on the output layer.
+     * @note This function should be used on the output layer. The returned gradient is owned by the layer.
      */
-    [[nodiscard]] std::pair<Matrix, double> loss(const Matrix& label, const Matrix& prediction, loss::Type loss);
+    [[nodiscard]] std::pair<const Matrix<T>&, double> loss(const MatrixView<T>& label, const MatrixView<T>& prediction, loss::Type loss);
 
     /**
-     * @brief Updates the weights and biases using the optimizer, learning rate, regularization, and weight decay settings.
-     * @param learning_rate Learning rate for the update.
-     * @param regularization Regularization settings for the update.
-     * @param weight_decay Weight decay factor for regularization.
+     * @brief Computes the softmax cross-entropy loss and its gradient from the logits of forward_logits and class indices.
+     * @param labels Class index of every sample of the batch.
+     * @return Pair containing the gradient for the previous layer and the computed loss value.
+     * @throws std::logic_error if the activation of the layer is not softmax.
+     * @note This function should be used on the output layer. The returned gradient is owned by the layer.
      */
-    void update(double learning_rate, const regularization::Settings& regularization, double weight_decay);
-    
+    [[nodiscard]] std::pair<const Matrix<T>&, double> loss(std::span<const int> labels);
+
     /**
      * @brief Predicts the output for the given input using the layer's weights and biases.
      * @param a_prev Input matrix to predict from.
      * @return Predicted output matrix after applying the activation function.
      */
-    [[nodiscard]] Matrix predict(const Matrix& a_prev) const;
+    [[nodiscard]] Matrix<T> predict(const MatrixView<T>& a_prev) const;
+
+    /**
+     * @brief Predicts the output for the given input into a caller-owned destination.
+     * @param out Destination, resized to (output x a_prev.cols()) only if its shape differs.
+     * @param a_prev Input matrix to predict from.
+     * @note out must not overlap a_prev. The pre-activation is a scratch matrix, drawn from
+     * the current arena when a pool::ArenaScope is open.
+     */
+    void predict_into(Matrix<T>& out, const MatrixView<T>& a_prev) const;
+
+    /**
+     * @brief Returns the weights used by the forward pass.
+     * @return View of the (output x input) weight matrix.
+     */
+    [[nodiscard]] MatrixView<T> weights() const noexcept { return w.view(); }
+
+    /**
+     * @brief Returns the biases used by the forward pass.
+     * @return View of the (output x 1) bias vector.
+     */
+    [[nodiscard]] MatrixView<T> biases() const noexcept { return b.view(); }
+
+    /**
+     * @brief Returns the activation function of the layer.
+     * @return The activation function type.
+     */
+    [[nodiscard]] activation::Type activation_type() const noexcept { return activation; }
+
+    /**
+     * @brief Sets whether backward and loss compute the gradient with respect to the input.
+     * @param needed False when no layer before this one is trained, such as for the input layer.
+     */
+    void set_input_gradient(bool needed) noexcept { input_gradient = needed; }
+
+    /**
+     * @brief Returns whether backward and loss compute the gradient with respect to the input.
+     * @return True if the gradient for the previous layer is computed.
+     */
+    [[nodiscard]] bool needs_input_gradient() const noexcept { return input_gradient; }
 private:
     /**
      * @brief Activation function used in the layer.
@@ -87,52 +192,63 @@ private:
     activation::Type activation;
 
     /**
-     * @brief Weight matrix for the layer.
+     * @brief Weight matrix for the layer, drawn from the flat weight buffer.
      */
-    Matrix w;
+    Matrix<T> w;
 
     /**
-     * @brief Bias vector for the layer.
+     * @brief Bias vector for the layer, drawn from the flat bias buffer.
      */
-    Matrix b;
+    Matrix<T> b;
 
     /**
      * @brief Linear combination of inputs and weights.
      */
-    Matrix z;
+    Matrix<T> z;
 
     /**
-     * @brief Cached input from the previous layer for backpropagation.
+     * @brief Output of the activation function.
      */
-    Matrix cached_input;
+    Matrix<T> a;
 
     /**
-     * @brief Gradient of the weights with respect to the loss.
+     * @brief Gradient of the loss with respect to z.
      */
-    Matrix dw;
+    Matrix<T> delta;
 
     /**
-     * @brief Gradient of the biases with respect to the loss.
+     * @brief Gradient of the loss with respect to the input, passed to the previous layer.
      */
-    Matrix db;
+    Matrix<T> da_prev;
 
     /**
-     * @brief Optimizer for the weights.
+     * @brief Whether da_prev is computed by backpropagation.
      */
-    std::shared_ptr<optimizer::Base> optimizer_w;
-    
+    bool input_gradient = true;
+
     /**
-     * @brief Optimizer for the biases.
+     * @brief View of the input from the previous layer, cached for backpropagation.
      */
-    std::shared_ptr<optimizer::Base> optimizer_b;
+    MatrixView<T> cached_input;
 
     /**
-     * @brief Adds a column vector to each column of a matrix.
-     * @param matrix The matrix to which the column vector will be added.
-     * @param column The column vector to be added.
-     * @return A new matrix with the column vector added to each column of the input matrix.
-     * @throws std::invalid_argument if the column vector's size does not match the number
-     * of rows in the matrix or if the column vector is not a single column.
+     * @brief Sparse input cached by the sparse forward pass, or nullptr after a dense one.
+     */
+    const SparseMatrix<T>* cached_sparse_input = nullptr;
+
+    /**
+     * @brief Gradient of the weights with respect to the loss, drawn from the flat weight gradient buffer.
+     */
+    Matrix<T> dw;
+
+    /**
+     * @brief Gradient of the biases with respect to the loss, drawn from the flat bias gradient buffer.
+     */
+    Matrix<T> db;
+
+    /**
+     * @brief Computes the weight and bias gradients from delta and, unless the input gradient is disabled, propagates delta to the previous layer.
+     * @return Gradient matrix for the previous layer.
      */
-    [[nodiscard]] Matrix broadcast_col_add(const Matrix& matrix, const Matrix& column) const;
+    const Matrix<T>& backpropagate_delta();
 };
@@ -1,11 +1,15 @@
 #include "Loss.h"
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <limits>
 #include <format>
 #include <stdexcept>
 
+template <typename T>
 double loss::compute(
-    const Matrix& label,
-    const Matrix& prediction,
+    const MatrixView<T>& label,
+    const MatrixView<T>& prediction,
     loss::Type type
 ) {
     const int ROWS = label.rows();
@@ -23,7 +27,7 @@ double loss::compute(
         case Type::CrossEntropy: {
             for (int row { 0 }; row < ROWS; ++row) {
                 for (int col { 0 }; col < COLS; ++col) {
-                    if (label[row, col] > 0.0) {
+                    if (label[row, col] > T { 0 }) {
                         total -= std::log(prediction[row, col] + loss::EPSILON);
                     }
                 }
@@ -33,7 +37,7 @@ double loss::compute(
         case Type::MSE: {
             for (int row { 0 }; row < ROWS; ++row) {
                 for (int col { 0 }; col < COLS; ++col) {
-                    const double diff = prediction[row, col] - label[row, col];
+                    const double diff = static_cast<double>(prediction[row, col]) - label[row, col];
                     total += diff * diff;
                 }
             }
@@ -44,26 +48,145 @@ double loss::compute(
     }
 }
 
-Matrix loss::gradient(
-    const Matrix &label, 
-    const Matrix &prediction, 
-    const Matrix &z, 
+template <typename T>
+Matrix<T> loss::gradient(
+    const MatrixView<T>& label,
+    const MatrixView<T>& prediction,
+    const MatrixView<T>& z,
     loss::Type type, 
     activation::Type activation
+) {
+    Matrix<T> out { prediction.rows(), prediction.cols() };
+    gradient_into<T>(out, label, prediction, z, type, activation);
+    return out;
+}
+
+template <typename T>
+void loss::gradient_into(
+    Matrix<T>& out,
+    const ViewArg<T>& label,
+    const ViewArg<T>& prediction,
+    const ViewArg<T>& z,
+    loss::Type type,
+    activation::Type activation
 ) {
     switch (type) {
         case Type::CrossEntropy:
             if (activation == activation::Type::Softmax
                 || activation == activation::Type::Sigmoid) {
-                return prediction - label;
+                out.assign(prediction);
+                out -= label;
+                return;
             }
             else {
                 throw std::invalid_argument("unsupported activation function for cross entropy loss");
             }
         case Type::MSE:
-            return (prediction - label)
-                .hadamard(activation::apply_prime(z, activation));
+            activation::apply_prime_into(out, z, activation);
+            for (int row { 0 }; row < out.rows(); ++row) {
+                for (int col { 0 }; col < out.cols(); ++col) {
+                    out[row, col] *= prediction[row, col] - label[row, col];
+                }
+            }
+            return;
         default:
             throw std::invalid_argument("unknown loss function type");
     }
 }
+
+/**
+ * @brief Number of columns the fused softmax cross-entropy processes at a time, with their maxima and sums on the stack.
+ */
+static constexpr int SOFTMAX_BLOCK = 64;
+
+template <typename T>
+double loss::softmax_cross_entropy_into(Matrix<T>& gradient, const ViewArg<T>& logits, std::span<const int> labels) {
+    const int rows = logits.rows();
+    const int cols = logits.cols();
+    if (static_cast<int>(labels.size()) != cols) {
+        throw std::invalid_argument(std::format(
+            "mismatch between number of labels ({}) and logit columns ({})",
+            labels.size(), cols
+        ));
+    }
+    for (int col { 0 }; col < cols; ++col) {
+        if (labels[col] < 0 || labels[col] >= rows) {
+            throw std::out_of_range(std::format(
+                "label {} of column {} out of range for {} classes", labels[col], col, rows
+            ));
+        }
+    }
+    gradient.resize(rows, cols);
+
+    /* Columns are split across threads; each thread sweeps its block row by row, so the inner loops are contiguous */
+    Matrix<double> losses = Matrix<double>::scratch(1, cols);
+    parallel::for_each_chunk(static_cast<size_t>(cols), parallel::GRAIN / static_cast<size_t>(std::max(rows, 1)), [&](size_t first, size_t last) {
+        for (int begin { static_cast<int>(first) }; begin < static_cast<int>(last); begin += SOFTMAX_BLOCK) {
+            const int width = std::min(SOFTMAX_BLOCK, static_cast<int>(last) - begin);
+            std::array<T, SOFTMAX_BLOCK> max;
+            std::array<T, SOFTMAX_BLOCK> sum;
+            max.fill(-std::numeric_limits<T>::infinity());
+            sum.fill(T { 0 });
+
+            for (int row { 0 }; row < rows; ++row) {
+                for (int j { 0 }; j < width; ++j) {
+                    max[j] = std::max(max[j], logits[row, begin + j]);
+                }
+            }
+            for (int row { 0 }; row < rows; ++row) {
+                T* out = &gradient[row, begin];
+                for (int j { 0 }; j < width; ++j) {
+                    out[j] = std::exp(logits[row, begin + j] - max[j]);
+                    sum[j] += out[j];
+                }
+            }
+
+            for (int j { 0 }; j < width; ++j) {
+                const int label = labels[begin + j];
+                losses[0, begin + j] = std::log(static_cast<double>(sum[j])) + max[j] - logits[label, begin + j];
+                sum[j] = T { 1 } / sum[j];
+            }
+            for (int row { 0 }; row < rows; ++row) {
+                T* out = &gradient[row, begin];
+                for (int j { 0 }; j < width; ++j) {
+                    out[j] *= sum[j];
+                }
+            }
+            for (int j { 0 }; j < width; ++j) {
+                gradient[labels[begin + j], begin + j] -= T { 1 };
+            }
+        }
+    }, static_cast<size_t>(rows) * static_cast<size_t>(cols));
+
+    /* Summed in column order, so the loss does not depend on how the columns were split */
+    double total = 0.0;
+    for (int col { 0 }; col < cols; ++col) {
+        total += losses[0, col];
+    }
+    return total / cols;
+}
+
+template <typename T>
+void loss::classes_into(std::vector<int>& out, const MatrixView<T>& label) {
+    out.resize(static_cast<size_t>(label.cols()));
+    for (int col { 0 }; col < label.cols(); ++col) {
+        int best = 0;
+        for (int row { 1 }; row < label.rows(); ++row) {
+            if (label[row, col] > label[best, col]) {
+                best = row;
+            }
+        }
+        out[col] = best;
+    }
+}
+
+template double loss::compute(const MatrixView<float>&, const MatrixView<float>&, loss::Type);
+template Matrix<float> loss::gradient(const MatrixView<float>&, const MatrixView<float>&, const MatrixView<float>&, loss::Type, activation::Type);
+template void loss::gradient_into(Matrix<float>&, const ViewArg<float>&, const ViewArg<float>&, const ViewArg<float>&, loss::Type, activation::Type);
+template double loss::softmax_cross_entropy_into(Matrix<float>&, const ViewArg<float>&, std::span<const int>);
+template void loss::classes_into(std::vector<int>&, const MatrixView<float>&);
+template double loss::compute(const MatrixView<double>&, const MatrixView<double>&, loss::Type);
+template Matrix<double> loss::gradient(const MatrixView<double>&, const MatrixView<double>&, const MatrixView<double>&, loss::Type, activation::Type);
+template void loss::gradient_into(Matrix<double>&, const ViewArg<double>&, const ViewArg<double>&, const ViewArg<double>&, loss::Type, activation::Type);
+template double loss::softmax_cross_entropy_into(Matrix<double>&, const ViewArg<double>&, std::span<const int>);
+template void loss::classes_into(std::vector<int>&, const MatrixView<double>&);
@@ -2,6 +2,8 @@
 
 #include "Activation.h"
 #include "Matrix.h"
+#include <span>
+#include <vector>
 
 /**
  * @namespace loss
@@ -29,12 +31,13 @@ namespace loss {
      * @param label The ground truth labels.
      * @param prediction The predicted values.
      * @param type The type of loss function to use.
-     * @return The computed loss value.
+     * @return The computed loss value, accumulated in double precision.
      * @throws std::invalid_argument if the label and prediction matrices have different shapes.
      */
+    template <typename T>
     [[nodiscard]] double compute(
-        const Matrix& label,
-        const Matrix& prediction,
+        const MatrixView<T>& label,
+        const MatrixView<T>& prediction,
         loss::Type type
     );
 
@@ -48,11 +51,58 @@ namespace loss {
      * @return A matrix representing the gradient of the loss with respect to the prediction.
      * @throws std::invalid_argument if an unsupported activation function is used with cross-entropy loss.
      */
-    [[nodiscard]] Matrix gradient(
-        const Matrix &label,
-        const Matrix &prediction, 
-        const Matrix &z, 
+    template <typename T>
+    [[nodiscard]] Matrix<T> gradient(
+        const MatrixView<T>& label,
+        const MatrixView<T>& prediction,
+        const MatrixView<T>& z,
         loss::Type type, 
         activation::Type activation
     );
+
+    /**
+     * @brief Computes the gradient of the loss function with respect to the prediction into a caller-owned destination.
+     * @param out Destination, resized to the shape of the prediction only if its shape differs.
+     * @param label The ground truth labels.
+     * @param prediction The predicted values.
+     * @param z The input to the activation function (used for backpropagation).
+     * @param type The type of loss function to use.
+     * @param activation The type of activation function used in the network.
+     * @throws std::invalid_argument if an unsupported activation function is used with cross-entropy loss.
+     * @note out must not overlap label, prediction or z.
+     */
+    template <typename T>
+    void gradient_into(
+        Matrix<T>& out,
+        const ViewArg<T>& label,
+        const ViewArg<T>& prediction,
+        const ViewArg<T>& z,
+        loss::Type type,
+        activation::Type activation
+    );
+
+    /**
+     * @brief Computes the softmax cross-entropy of a batch of logits against class indices, and its gradient, in one pass per column.
+     * @details Each column is shifted by its maximum, so the loss is log-sum-exp(z) - z[label] and never
+     * takes the log of a rounded probability. The exponentials are written once into gradient, then
+     * normalized and reduced by one at the label, giving softmax(z) - one_hot(label) without forming
+     * either the softmax or the one-hot matrix.
+     * @param gradient Destination of the gradient with respect to the logits, resized to the shape of the logits only if its shape differs.
+     * @param logits The linear outputs of the softmax layer, one sample per column.
+     * @param labels The class index of every column.
+     * @return The mean loss of the batch, accumulated in double precision.
+     * @throws std::invalid_argument if the number of labels does not match the number of columns.
+     * @throws std::out_of_range if a label is not a row of the logits.
+     * @note gradient must not overlap logits.
+     */
+    template <typename T>
+    [[nodiscard]] double softmax_cross_entropy_into(Matrix<T>& gradient, const ViewArg<T>& logits, std::span<const int> labels);
+
+    /**
+     * @brief Converts label columns (one-hot or class probabilities) into class indices.
+     * @param out Destination, resized to the number of columns.
+     * @param label The label matrix, one sample per column.
+     */
+    template <typename T>
+    void classes_into(std::vector<int>& out, const MatrixView<T>& label);
 }
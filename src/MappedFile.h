@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of a whole file.
+ * @details The pages are loaded by the kernel on first access and shared with the page cache,
+ * so opening a large file costs no read and no copy. The mapping is released when the object is destroyed.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Maps a file.
+     * @param path Path to the file.
+     * @throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(std::string_view path);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Move constructor; the moved-from object no longer maps anything.
+     */
+    MappedFile(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Move assignment operator; the previous mapping is released.
+     */
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Returns the contents of the file.
+     * @return The mapped bytes (empty for an empty file).
+     */
+    [[nodiscard]] std::span<const uint8_t> bytes() const noexcept { return {m_data, m_size}; }
+private:
+    /**
+     * @brief Start of the mapping, or nullptr if nothing is mapped.
+     */
+    const uint8_t* m_data = nullptr;
+
+    /**
+     * @brief Size of the mapping in bytes.
+     */
+    std::size_t m_size = 0;
+};
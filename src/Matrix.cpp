@@ -1,118 +1,166 @@
 #include "Matrix.h"
+#include "Gemm.h"
+#include "Simd.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
 #include <format>
+#include <optional>
 #include <iomanip>
 #include <stdexcept>
 
-Matrix Matrix::row(int index) const {
-    index = validate_row(index);
-    Matrix row {1, m_cols};
-    for (int col { 0 }; col < m_cols; ++col) {
-        row[0, col] = (*this)[index, col];
-    }
-    return row;
+/**
+ * @brief Copies a view into a contiguous temporary, drawn from the current arena if a scope is open.
+ */
+template <typename T>
+[[nodiscard]] static Matrix<T> scratch_copy(const MatrixView<T>& view) {
+    Matrix<T> copy = Matrix<T>::scratch(view.rows(), view.cols());
+    copy.assign(view);
+    return copy;
 }
 
-Matrix Matrix::rows(int start, int end) const {
-    validate_row_range(start, end);
-    Matrix slice {end - start, m_cols};
-    for (int row { start }; row < end; ++row) {
-        for (int col { 0 }; col < m_cols; ++col) {
-            slice[row - start, col] = (*this)[row, col];
-        }
+/**
+ * @brief Applies a kernel element-wise between a matrix and a view of the same shape.
+ * @details The kernel receives (dst, src, n) spans; contiguous views are processed as one flat
+ * range and views with unit column stride row by row, anything else is copied first.
+ */
+template <typename T, typename Kernel>
+static void zip(Matrix<T>& out, const MatrixView<T>& rhs, Kernel&& kernel) {
+    T* dst = &out[0, 0];
+    const size_t size = static_cast<size_t>(out.rows()) * static_cast<size_t>(out.cols());
+    if (rhs.is_contiguous()) {
+        const T* src = rhs.data();
+        parallel::for_each_chunk(size, parallel::GRAIN, [&](size_t first, size_t last) {
+            kernel(dst + first, src + first, last - first);
+        });
+    } else if (rhs.col_stride() == 1) {
+        parallel::for_each_chunk(static_cast<size_t>(out.rows()), 1, [&](size_t first, size_t last) {
+            for (int row { static_cast<int>(first) }; row < static_cast<int>(last); ++row) {
+                kernel(&out[row, 0], &rhs[row, 0], static_cast<size_t>(out.cols()));
+            }
+        }, size);
+    } else {
+        zip(out, scratch_copy(rhs).view(), std::forward<Kernel>(kernel));
     }
-    return slice;
 }
 
-Matrix Matrix::col(int index) const {
-    index = validate_col(index);
-    Matrix col {m_rows, 1};
-    for (int row { 0 }; row < m_rows; ++row) {
-        col[row, 0] = (*this)[row, index];
-    }
-    return col;
+template <typename T>
+Matrix<T>::Matrix(const MatrixView<T>& view)
+    : Matrix(view.rows(), view.cols())
+{
+    assign(view);
 }
 
-Matrix Matrix::cols(int start, int end) const {
-    validate_col_range(start, end);
-    Matrix slice {m_rows, end - start};
-    for (int row { 0 }; row < m_rows; ++row) {
-        for (int col { start }; col < end; ++col) {
-            slice[row, col - start] = (*this)[row, col];
-        }
+template <typename T>
+void Matrix<T>::resize(int rows, int cols) {
+    if (rows == m_rows && cols == m_cols) {
+        return;
     }
-    return slice;
+    m_rows = validate_dimension(rows);
+    m_cols = validate_dimension(cols);
+    m_data.resize(static_cast<size_t>(rows) * static_cast<size_t>(cols));
+}
+
+template <typename T>
+void Matrix<T>::assign(const MatrixView<T>& view) {
+    resize(view.rows(), view.cols());
+    const size_t cols = static_cast<size_t>(m_cols);
+    parallel::for_each_chunk(static_cast<size_t>(m_rows), 1, [&](size_t first, size_t last) {
+        for (size_t row { first }; row < last; ++row) {
+            T* dst = m_data.data() + row * cols;
+            if (view.col_stride() == 1) {
+                std::copy_n(&view[static_cast<int>(row), 0], cols, dst);
+            } else {
+                for (size_t col { 0 }; col < cols; ++col) {
+                    dst[col] = view[static_cast<int>(row), static_cast<int>(col)];
+                }
+            }
+        }
+    }, m_data.size());
 }
 
-Matrix Matrix::slice(int row_start, int row_end, int col_start, int col_end) const {
-    validate_row_range(row_start, row_end);
-    validate_col_range(col_start, col_end);
-    Matrix slice {row_end - row_start, col_end - col_start};
-    for (int row { row_start }; row < row_end; ++row) {
-        for (int col { col_start }; col < col_end; ++col) {
-            slice[row - row_start, col - col_start] = (*this)[row, col];
-        }
-    }
-    return slice;
+template <typename T>
+Matrix<T> Matrix<T>::row(int index) const {
+    return Matrix { view().row(index) };
 }
 
-void Matrix::fill(double value) noexcept {
-    std::fill(m_data.begin(), m_data.end(), value);
+template <typename T>
+Matrix<T> Matrix<T>::rows(int start, int end) const {
+    return Matrix { view().rows(start, end) };
 }
 
-Matrix& Matrix::operator+=(const Matrix &rhs) {
-    check_matching_dimensions(rhs);
-    for (size_t idx { 0 }; idx < m_data.size(); ++idx) {
-        m_data[idx] += rhs.m_data[idx];
-    }
-    return *this;
+template <typename T>
+Matrix<T> Matrix<T>::col(int index) const {
+    return Matrix { view().col(index) };
 }
 
-Matrix operator+(Matrix m1, const Matrix& m2) {
-    return m1 += m2;
+template <typename T>
+Matrix<T> Matrix<T>::cols(int start, int end) const {
+    return Matrix { view().cols(start, end) };
 }
 
-Matrix& Matrix::operator-=(const Matrix &rhs) {
+template <typename T>
+Matrix<T> Matrix<T>::slice(int row_start, int row_end, int col_start, int col_end) const {
+    return Matrix { view().slice(row_start, row_end, col_start, col_end) };
+}
+
+template <typename T>
+void Matrix<T>::fill(T value) noexcept {
+    parallel::for_each_chunk(m_data.size(), parallel::GRAIN, [&](size_t first, size_t last) {
+        simd::fill(m_data.data() + first, value, last - first);
+    });
+}
+
+template <typename T>
+Matrix<T>& Matrix<T>::operator+=(const MatrixView<T>& rhs) {
     check_matching_dimensions(rhs);
-    for (size_t idx { 0 }; idx < m_data.size(); ++idx) {
-        m_data[idx] -= rhs.m_data[idx];
-    }
+    zip(*this, rhs, simd::add<T>);
     return *this;
 }
 
-Matrix operator-(Matrix m1, const Matrix& m2) {
-    return m1 -= m2;
+template <typename T>
+Matrix<T> operator+(Matrix<T> m1, const ViewArg<T>& m2) {
+    return m1 += m2;
 }
 
-Matrix& Matrix::operator*=(double scalar) noexcept {
-    for (auto& element : m_data) {
-        element *= scalar;
-    }
+template <typename T>
+Matrix<T>& Matrix<T>::operator-=(const MatrixView<T>& rhs) {
+    check_matching_dimensions(rhs);
+    zip(*this, rhs, simd::sub<T>);
     return *this;
 }
 
-Matrix operator*(Matrix matrix, double scalar) {
-    return matrix *= scalar;
+template <typename T>
+Matrix<T> operator-(Matrix<T> m1, const ViewArg<T>& m2) {
+    return m1 -= m2;
 }
 
-Matrix operator*(double scalar, Matrix matrix) {
-    return matrix *= scalar;
+template <typename T>
+Matrix<T>& Matrix<T>::operator*=(T scalar) noexcept {
+    parallel::for_each_chunk(m_data.size(), parallel::GRAIN, [&](size_t first, size_t last) {
+        simd::scale(m_data.data() + first, scalar, last - first);
+    });
+    return *this;
 }
 
-Matrix& Matrix::operator/=(double scalar) {
-    if (scalar == 0.0) {
+template <typename T>
+Matrix<T>& Matrix<T>::operator/=(T scalar) {
+    if (scalar == T { 0 }) {
         throw std::invalid_argument("cannot perform division by zero");
     }
-    for (auto& element : m_data) {
-        element /= scalar;
-    }
+    parallel::for_each_chunk(m_data.size(), parallel::GRAIN, [&](size_t first, size_t last) {
+        simd::div_scalar(m_data.data() + first, scalar, last - first);
+    });
     return *this;
 }
 
-Matrix operator/(Matrix matrix, double scalar) {
+template <typename T>
+Matrix<T> operator/(Matrix<T> matrix, std::type_identity_t<T> scalar) {
     return matrix /= scalar;
 }
 
-Matrix Matrix::operator-() const {
+template <typename T>
+Matrix<T> Matrix<T>::operator-() const {
     Matrix m { *this };
     for (auto& element : m.m_data) {
         element = -element;
@@ -120,115 +168,383 @@ Matrix Matrix::operator-() const {
     return m;
 }
 
+template <typename T>
+Matrix<T> Matrix<T>::flatten(bool col) const {    
+    Matrix flattened { 
+        col ? m_rows * m_cols : 1, 
+        col ? 1 : m_rows * m_cols 
+    };
+    std::copy(m_data.begin(), m_data.end(), flattened.m_data.begin());
+    return flattened;
+}
+
+template <typename T>
+Matrix<T> Matrix<T>::transpose() const {
+    Matrix transposed { m_cols, m_rows };
+    transpose_into(transposed, *this);
+    return transposed;
+}
+
 /**
- * @brief Compares two matrices for equality.
- * @param lhs The left-hand side matrix.
- * @param rhs The right-hand side matrix.
- * @return True if the matrices are equal, false otherwise.
- * @note Two matrices are considered equal if they have the same dimensions and 
- * all corresponding elements are equal.
+ * @brief Largest block side, in elements, transposed without further splitting (a 32x32 block of doubles is 8 KiB).
  */
-[[nodiscard]] bool operator==(const Matrix& lhs, const Matrix& rhs) noexcept {
-    if (lhs.rows() != rhs.rows()) { return false; }
-    if (lhs.cols() != rhs.cols()) { return false; }
-    return lhs.m_data == rhs.m_data;
+static constexpr int TRANSPOSE_LEAF = 32;
+
+/**
+ * @brief Rounds half of a block side up to a whole number of tiles, so only the last block has ragged edges.
+ */
+template <typename T>
+[[nodiscard]] static int split_point(int side) noexcept {
+    constexpr int tile = simd::TILE<T>;
+    return (side / 2 + tile - 1) / tile * tile;
 }
 
 /**
- * @brief Compares two matrices for inequality.
- * @param lhs The left-hand side matrix.
- * @param rhs The right-hand side matrix.
- * @return True if the matrices are not equal, false otherwise.
- * @note Two matrices are considered not equal if they differ in dimensions or 
- * any corresponding elements are not equal.
+ * @brief Transposes a block whose rows are contiguous into dst (dst[j][i] = src[i][j]).
+ * @details Cache-oblivious: the longer side is halved until the block fits in L1, whatever the
+ * cache sizes, and the leaf is walked in simd::TILE x simd::TILE register tiles; the ragged edges
+ * are copied element by element.
  */
-[[nodiscard]] bool operator!=(const Matrix& lhs, const Matrix& rhs) noexcept {
-    return !(lhs == rhs);
+template <typename T>
+static void transpose_block(const T* src, std::ptrdiff_t src_stride, T* dst, std::ptrdiff_t dst_stride, int rows, int cols) noexcept {
+    if (rows > TRANSPOSE_LEAF && rows >= cols) {
+        const int half = split_point<T>(rows);
+        transpose_block(src, src_stride, dst, dst_stride, half, cols);
+        transpose_block(src + half * src_stride, src_stride, dst + half, dst_stride, rows - half, cols);
+        return;
+    }
+    if (cols > TRANSPOSE_LEAF) {
+        const int half = split_point<T>(cols);
+        transpose_block(src, src_stride, dst, dst_stride, rows, half);
+        transpose_block(src + half, src_stride, dst + half * dst_stride, dst_stride, rows, cols - half);
+        return;
+    }
+    constexpr int tile = simd::TILE<T>;
+    const int tiled_rows = rows / tile * tile;
+    const int tiled_cols = cols / tile * tile;
+    for (int i { 0 }; i < tiled_rows; i += tile) {
+        for (int j { 0 }; j < tiled_cols; j += tile) {
+            simd::transpose_tile(src + i * src_stride + j, src_stride, dst + j * dst_stride + i, dst_stride);
+        }
+        for (int r { i }; r < i + tile; ++r) {
+            for (int j { tiled_cols }; j < cols; ++j) {
+                dst[j * dst_stride + r] = src[r * src_stride + j];
+            }
+        }
+    }
+    for (int i { tiled_rows }; i < rows; ++i) {
+        for (int j { 0 }; j < cols; ++j) {
+            dst[j * dst_stride + i] = src[i * src_stride + j];
+        }
+    }
 }
 
-Matrix Matrix::flatten(bool col) const {    
-    Matrix flattened { 
-        col ? m_rows * m_cols : 1, 
-        col ? 1 : m_rows * m_cols 
-    };
-    std::copy(m_data.begin(), m_data.end(), flattened.m_data.begin());
-    return flattened;
+template <typename T>
+void transpose_into(Matrix<T>& out, const ViewArg<T>& matrix) {
+    const int rows = matrix.rows();
+    const int cols = matrix.cols();
+    out.resize(cols, rows);
+    if (rows == 0 || cols == 0) {
+        return;
+    }
+    if (matrix.col_stride() != 1) {
+        if (matrix.row_stride() == 1) {
+            /* A transposed view of contiguous storage: its transpose is a plain row copy */
+            out.assign(matrix.transpose());
+            return;
+        }
+        parallel::for_each_chunk(static_cast<size_t>(rows), 8, [&](size_t first, size_t last) {
+            for (int row { static_cast<int>(first) }; row < static_cast<int>(last); ++row) {
+                for (int col { 0 }; col < cols; ++col) {
+                    out[col, row] = matrix[row, col];
+                }
+            }
+        }, static_cast<size_t>(rows) * static_cast<size_t>(cols));
+        return;
+    }
+    const T* src = matrix.data();
+    const std::ptrdiff_t src_stride = matrix.row_stride();
+    T* dst = &out[0, 0];
+    const std::ptrdiff_t dst_stride = rows;
+    /* Workers take whole leaf-sized slabs along the longer side and recurse within them */
+    const bool by_rows = rows >= cols;
+    parallel::for_each_chunk(static_cast<size_t>(by_rows ? rows : cols), TRANSPOSE_LEAF, [&](size_t first, size_t last) {
+        const int begin = static_cast<int>(first);
+        const int count = static_cast<int>(last - first);
+        if (by_rows) {
+            transpose_block(src + begin * src_stride, src_stride, dst + begin, dst_stride, count, cols);
+        } else {
+            transpose_block(src + begin, src_stride, dst + begin * dst_stride, dst_stride, rows, count);
+        }
+    }, static_cast<size_t>(rows) * static_cast<size_t>(cols));
 }
 
-Matrix Matrix::transpose() const {
-    Matrix transposed { m_cols, m_rows };
-    for (int row { 0 }; row < m_rows; ++row) {
-        for (int col { 0 }; col < m_cols; ++col) {
-            transposed[col, row] = (*this)[row, col];
+template <typename T>
+void Matrix<T>::transpose_in_place() {
+    if (m_rows != m_cols) {
+        const Matrix copy = scratch_copy(view());
+        transpose_into(*this, copy);
+        return;
+    }
+    constexpr int tile = simd::TILE<T>;
+    const int n = m_rows;
+    const int tiles = n / tile;
+    T* data = m_data.data();
+    /* Each worker owns whole rows of tiles and swaps them with the matching columns of tiles */
+    parallel::for_each_chunk(static_cast<size_t>(tiles), 1, [&](size_t first, size_t last) {
+        alignas(pool::ALIGNMENT) T upper[tile * tile];
+        alignas(pool::ALIGNMENT) T lower[tile * tile];
+        for (int ti { static_cast<int>(first) }; ti < static_cast<int>(last); ++ti) {
+            const int i = ti * tile;
+            T* diagonal = data + i * n + i;
+            simd::transpose_tile(diagonal, n, upper, tile);
+            for (int r { 0 }; r < tile; ++r) {
+                std::copy_n(upper + r * tile, tile, diagonal + r * n);
+            }
+            for (int j { i + tile }; j + tile <= n; j += tile) {
+                T* above = data + i * n + j;
+                T* below = data + j * n + i;
+                simd::transpose_tile(above, n, upper, tile);
+                simd::transpose_tile(below, n, lower, tile);
+                for (int r { 0 }; r < tile; ++r) {
+                    std::copy_n(upper + r * tile, tile, below + r * n);
+                    std::copy_n(lower + r * tile, tile, above + r * n);
+                }
+            }
+        }
+    }, static_cast<size_t>(n) * static_cast<size_t>(n));
+    /* Ragged edge: the rows and columns past the last full tile */
+    for (int i { 0 }; i < n; ++i) {
+        for (int j { std::max(i + 1, tiles * tile) }; j < n; ++j) {
+            std::swap(data[i * n + j], data[j * n + i]);
         }
     }
-    return transposed;
 }
 
-Matrix Matrix::hadamard(const Matrix& matrix) const {
+template <typename T>
+Matrix<T> Matrix<T>::hadamard(const MatrixView<T>& matrix) const {
     check_matching_dimensions(matrix);
     Matrix product { *this };
-    for (int row { 0 }; row < m_rows; ++row) {
-        for (int col { 0 }; col < m_cols; ++col) {
-            product[row, col] *= matrix[row, col];
-        }
+    zip(product, matrix, simd::mul<T>);
+    return product;
+}
+
+/**
+ * @brief Checks whether a view covers exactly the elements of a matrix.
+ */
+template <typename T>
+[[nodiscard]] static bool same_storage(const Matrix<T>& matrix, const MatrixView<T>& view) noexcept {
+    return view.data() == matrix.view().data() && view.shape() == matrix.shape() && view.is_contiguous();
+}
+
+template <typename T>
+void hadamard_into(Matrix<T>& out, const ViewArg<T>& lhs, const ViewArg<T>& rhs) {
+    if (lhs.rows() != rhs.rows() || lhs.cols() != rhs.cols()) {
+        throw std::invalid_argument(std::format(
+            "mismatched matrix dimensions ({}x{}) must be ({}x{})",
+            rhs.rows(), rhs.cols(), lhs.rows(), lhs.cols()
+        ));
+    }
+    if (same_storage(out, rhs)) {
+        zip(out, lhs, simd::mul<T>);
+        return;
+    }
+    if (!same_storage(out, lhs)) {
+        out.assign(lhs);
+    }
+    zip(out, rhs, simd::mul<T>);
+}
+
+/**
+ * @brief Describes how the engine should read a view: as stored or transposed, and with which leading dimension.
+ * @return Pair of the transposition flag and the leading dimension, or nullopt if neither stride is unit.
+ */
+template <typename T>
+[[nodiscard]] static std::optional<std::pair<gemm::Transpose, int>> gemm_layout(const MatrixView<T>& view) noexcept {
+    if (view.col_stride() == 1) {
+        return std::pair { gemm::Transpose::No, static_cast<int>(std::max<std::ptrdiff_t>(view.row_stride(), 1)) };
+    }
+    if (view.row_stride() == 1) {
+        return std::pair { gemm::Transpose::Yes, static_cast<int>(view.col_stride()) };
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Multiplies two views with the GEMM engine into out, reading both operands in place when possible.
+ * @note Operands without any unit stride are copied into a contiguous matrix first.
+ */
+template <typename T>
+static void multiply(Matrix<T>& out, const ViewArg<T>& lhs, const ViewArg<T>& rhs, const gemm::Epilogue<T>& epilogue = {}) {
+    const auto lhs_layout = gemm_layout(lhs);
+    if (!lhs_layout) {
+        return multiply(out, scratch_copy(lhs).view(), rhs, epilogue);
     }
+    const auto rhs_layout = gemm_layout(rhs);
+    if (!rhs_layout) {
+        return multiply(out, lhs, scratch_copy(rhs).view(), epilogue);
+    }
+    out.resize(lhs.rows(), rhs.cols());
+    gemm::multiply(
+        lhs_layout->first, rhs_layout->first,
+        lhs.rows(), rhs.cols(), lhs.cols(),
+        lhs.data(), lhs_layout->second,
+        rhs.data(), rhs_layout->second,
+        &out[0, 0], out.cols(),
+        epilogue
+    );
+}
+
+/**
+ * @brief Multiplies two views into a new matrix.
+ */
+template <typename T>
+[[nodiscard]] static Matrix<T> multiply(const MatrixView<T>& lhs, const MatrixView<T>& rhs) {
+    Matrix<T> product { lhs.rows(), rhs.cols() };
+    multiply(product, lhs, rhs);
     return product;
 }
 
-Matrix Matrix::matmul(const Matrix& matrix) const {
+template <typename T>
+void matmul_into(Matrix<T>& out, const ViewArg<T>& lhs, const ViewArg<T>& rhs) {
+    if (lhs.cols() != rhs.rows()) {
+        throw std::invalid_argument(std::format(
+            "mismatched matrix multiplication inner dimensions ({} and {})",
+            lhs.cols(), rhs.rows()
+        ));
+    }
+    multiply(out, lhs, rhs);
+}
+
+template <typename T>
+void matmul_into(
+    Matrix<T>& out, Matrix<T>& activated,
+    const ViewArg<T>& lhs, const ViewArg<T>& rhs,
+    const ViewArg<T>& bias, gemm::Activation activation
+) {
+    if (lhs.cols() != rhs.rows()) {
+        throw std::invalid_argument(std::format(
+            "mismatched matrix multiplication inner dimensions ({} and {})",
+            lhs.cols(), rhs.rows()
+        ));
+    }
+    if (bias.rows() != lhs.rows() || bias.cols() != 1) {
+        throw std::invalid_argument(std::format(
+            "mismatched bias dimensions ({}x{}) must be ({}x1)",
+            bias.rows(), bias.cols(), lhs.rows()
+        ));
+    }
+    if (bias.rows() > 1 && bias.row_stride() != 1) {
+        return matmul_into(out, activated, lhs, rhs, scratch_copy(bias).view(), activation);
+    }
+    const bool separate = &activated != &out;
+    if (separate) {
+        activated.resize(lhs.rows(), rhs.cols());
+    }
+    multiply(out, lhs, rhs, gemm::Epilogue<T> {
+        .bias = bias.data(),
+        .activation = activation,
+        .out = separate ? &activated[0, 0] : nullptr,
+        .ldo = activated.cols(),
+    });
+}
+
+template <typename T>
+Matrix<T> Matrix<T>::matmul(const MatrixView<T>& matrix) const {
     check_mult_dimensions(matrix);
-    Matrix product { rows(), matrix.cols(), 0.0 };
-    for (int i { 0 }; i < m_rows; ++i) {
-        for (int k { 0 }; k < m_cols; ++k) {
-            const double aik = (*this)[i, k];
-            for (int j {0}; j < matrix.cols(); ++j) {
-                product[i, j] += aik * matrix[k, j];
-            }
-        }
+    return multiply(view(), matrix);
+}
+
+template <typename T>
+Matrix<T> Matrix<T>::matmul_tn(const MatrixView<T>& matrix) const {
+    if (rows() != matrix.rows()) {
+        throw std::invalid_argument(std::format(
+            "mismatched matrix multiplication inner dimensions ({} and {})",
+            rows(), matrix.rows()
+        ));
     }
-    return product;
+    return multiply(view().transpose(), matrix);
+}
+
+template <typename T>
+Matrix<T> Matrix<T>::matmul_nt(const MatrixView<T>& matrix) const {
+    if (cols() != matrix.cols()) {
+        throw std::invalid_argument(std::format(
+            "mismatched matrix multiplication inner dimensions ({} and {})",
+            cols(), matrix.cols()
+        ));
+    }
+    return multiply(view(), matrix.transpose());
 }
 
-Matrix Matrix::hadamard_div(const Matrix& matrix) const {
+template <typename T>
+Matrix<T> Matrix<T>::hadamard_div(const MatrixView<T>& matrix) const {
     check_matching_dimensions(matrix);
     Matrix product { *this };
-    for (int row { 0 }; row < m_rows; ++row) {
-        for (int col { 0 }; col < m_cols; ++col) {
-            if (matrix[row, col] == 0.0) {
-                throw std::invalid_argument("cannot perform division by zero in Hadamard division");
-            }
-            product[row, col] /= matrix[row, col];
+    std::atomic<bool> valid { true };
+    zip(product, matrix, [&](T* dst, const T* src, size_t n) {
+        if (!simd::div<T>(dst, src, n)) {
+            valid = false;
         }
+    });
+    if (!valid) {
+        throw std::invalid_argument("cannot perform division by zero in Hadamard division");
     }
     return product;
 }
 
-Matrix Matrix::row_avg() const {
-    Matrix column {m_rows, 1, 0.0};
-    for (int row { 0 }; row < m_rows; ++row) {
-        for (int col { 0 }; col < m_cols; ++col) {
-            column[row, 0] += (*this)[row, col];
+template <typename T>
+Matrix<T> Matrix<T>::row_avg() const {
+    Matrix column {m_rows, 1};
+    row_avg_into(column, *this);
+    return column;
+}
+
+template <typename T>
+void row_avg_into(Matrix<T>& out, const ViewArg<T>& matrix) {
+    const int rows = matrix.rows();
+    const int cols = matrix.cols();
+    out.resize(rows, 1);
+    parallel::for_each_chunk(static_cast<size_t>(rows), 1, [&](size_t first, size_t last) {
+        for (int row { static_cast<int>(first) }; row < static_cast<int>(last); ++row) {
+            T sum { 0 };
+            if (matrix.col_stride() == 1) {
+                sum = simd::sum<T>(&matrix[row, 0], static_cast<size_t>(cols));
+            } else {
+                for (int col { 0 }; col < cols; ++col) {
+                    sum += matrix[row, col];
+                }
+            }
+            out[row, 0] = sum;
         }
-    }
-    return column / m_cols;
+    }, static_cast<size_t>(rows) * static_cast<size_t>(cols));
+    out /= cols;
 }
 
-Matrix Matrix::col_avg() const {
-    Matrix row {1, m_cols, 0.0};
-    for (int col { 0 }; col < m_cols; ++col) {
+template <typename T>
+Matrix<T> Matrix<T>::col_avg() const {
+    Matrix row {1, m_cols};
+    parallel::for_each_chunk(static_cast<size_t>(m_cols), parallel::GRAIN / 8, [&](size_t first, size_t last) {
         for (int row_idx { 0 }; row_idx < m_rows; ++row_idx) {
-            row[0, col] += (*this)[row_idx, col];
+            simd::add<T>(row.m_data.data() + first, &m_data[index(row_idx, static_cast<int>(first))], last - first);
         }
-    }
+    }, m_data.size());
     return row / m_rows;
 }
 
-Matrix operator*(const Matrix& lhs, const Matrix& rhs) {
-    return lhs.matmul(rhs);
+template <typename T>
+Matrix<T> operator*(const MatrixView<T>& lhs, const MatrixView<T>& rhs) {
+    if (lhs.cols() != rhs.rows()) {
+        throw std::invalid_argument(std::format(
+            "mismatched matrix multiplication inner dimensions ({} and {})",
+            lhs.cols(), rhs.rows()
+        ));
+    }
+    return multiply(lhs, rhs);
 }
 
-int Matrix::validate_dimension(int dim) {
+template <typename T>
+int Matrix<T>::validate_dimension(int dim) {
     if (dim <= 0){
         throw std::invalid_argument(std::format(
             "invalid matrix dimension ({}) must be >= 1",
@@ -238,7 +554,8 @@ int Matrix::validate_dimension(int dim) {
     return dim;
 }
 
-int Matrix::validate_row(int row) const {
+template <typename T>
+int Matrix<T>::validate_row(int row) const {
     if (row < 0 || row >= m_rows) {
         throw std::out_of_range(std::format(
             "row index ({}) is out of bounds [0, {}]",
@@ -248,22 +565,8 @@ int Matrix::validate_row(int row) const {
     return row;
 }
 
-void Matrix::validate_row_range(int start, int end) const {
-    if (start >= end) {
-        throw std::invalid_argument(std::format(
-            "invalid range specification [{},{}]",
-            start, end
-        ));
-    }
-    if (start < 0 || end > m_rows) {
-        throw std::out_of_range(std::format(
-            "row range [{},{}] is out of bounds [0, {}]",
-            start, end, m_rows - 1
-        ));
-    }
-}
-
-int Matrix::validate_col(int col) const {
+template <typename T>
+int Matrix<T>::validate_col(int col) const {
     if (col < 0 || col >= m_cols) {
         throw std::out_of_range(std::format(
             "col index ({}) is out of bounds [0, {}]",
@@ -273,31 +576,23 @@ int Matrix::validate_col(int col) const {
     return col;
 }
 
-void Matrix::validate_col_range(int start, int end) const {
-    if (start >= end) {
-        throw std::invalid_argument(std::format(
-            "invalid range specification [{},{}]",
-            start, end
-        ));
-    }
-    if (start < 0 || end > m_cols) {
-        throw std::out_of_range(std::format(
-            "col range [{},{}] is out of bounds [0, {}]",
-            start, end, m_cols - 1
-        ));
-    }
+template <typename T>
+void Matrix<T>::check_matching_dimensions(const MatrixView<T>& other) const {
+    check_matching_dimensions(other.rows(), other.cols());
 }
 
-void Matrix::check_matching_dimensions(const Matrix& other) const {
-    if (rows() != other.rows() || cols() != other.cols()) {
+template <typename T>
+void Matrix<T>::check_matching_dimensions(int rows, int cols) const {
+    if (m_rows != rows || m_cols != cols) {
         throw std::invalid_argument(std::format(
             "mismatched matrix dimensions ({}x{}) must be ({}x{})",
-            other.rows(), other.cols(), rows(), cols()
+            rows, cols, m_rows, m_cols
         ));
     } 
 }
 
-void Matrix::check_mult_dimensions(const Matrix& other) const {
+template <typename T>
+void Matrix<T>::check_mult_dimensions(const MatrixView<T>& other) const {
     if (cols() != other.rows()) {
         throw std::invalid_argument(std::format(
             "mismatched matrix multiplication inner dimensions ({} and {})",
@@ -306,7 +601,8 @@ void Matrix::check_mult_dimensions(const Matrix& other) const {
     } 
 }
 
-std::ostream& operator<<(std::ostream& out, const Matrix& matrix) {
+template <typename T>
+std::ostream& operator<<(std::ostream& out, const Matrix<T>& matrix) {
     out << std::fixed << std::setprecision(3);
     for (int row = 0; row < matrix.rows(); row++) {
         out << "[ ";
@@ -318,3 +614,27 @@ std::ostream& operator<<(std::ostream& out, const Matrix& matrix) {
     out << "(" << matrix.rows() << " rows, " << matrix.cols() << " cols)\n";
     return out;
 }
+
+template class Matrix<float>;
+template class Matrix<double>;
+
+template Matrix<float> operator+(Matrix<float>, const ViewArg<float>&);
+template Matrix<double> operator+(Matrix<double>, const ViewArg<double>&);
+template Matrix<float> operator-(Matrix<float>, const ViewArg<float>&);
+template Matrix<double> operator-(Matrix<double>, const ViewArg<double>&);
+template Matrix<float> operator/(Matrix<float>, float);
+template Matrix<double> operator/(Matrix<double>, double);
+template Matrix<float> operator*(const MatrixView<float>&, const MatrixView<float>&);
+template Matrix<double> operator*(const MatrixView<double>&, const MatrixView<double>&);
+template void matmul_into(Matrix<float>&, const ViewArg<float>&, const ViewArg<float>&);
+template void matmul_into(Matrix<double>&, const ViewArg<double>&, const ViewArg<double>&);
+template void matmul_into(Matrix<float>&, Matrix<float>&, const ViewArg<float>&, const ViewArg<float>&, const ViewArg<float>&, gemm::Activation);
+template void matmul_into(Matrix<double>&, Matrix<double>&, const ViewArg<double>&, const ViewArg<double>&, const ViewArg<double>&, gemm::Activation);
+template void hadamard_into(Matrix<float>&, const ViewArg<float>&, const ViewArg<float>&);
+template void hadamard_into(Matrix<double>&, const ViewArg<double>&, const ViewArg<double>&);
+template void transpose_into(Matrix<float>&, const ViewArg<float>&);
+template void transpose_into(Matrix<double>&, const ViewArg<double>&);
+template void row_avg_into(Matrix<float>&, const ViewArg<float>&);
+template void row_avg_into(Matrix<double>&, const ViewArg<double>&);
+template std::ostream& operator<<(std::ostream&, const Matrix<float>&);
+template std::ostream& operator<<(std::ostream&, const Matrix<double>&);
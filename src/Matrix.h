@@ -1,14 +1,33 @@
 #pragma once
 
+#include "Expression.h"
+#include "Gemm.h"
+#include "MatrixView.h"
+#include "Pool.h"
+#include "ThreadPool.h"
+#include <concepts>
 #include <ostream>
+#include <type_traits>
 #include <vector>
 
 /**
  * @class Matrix
- * @brief Representation of a 2D matrix of doubles.
+ * @brief Representation of a 2D matrix of scalars.
+ * @tparam T Element type (float or double).
  */
+template <typename T>
 class Matrix {
 public:
+    /**
+     * @brief Type of the elements.
+     */
+    using value_type = T;
+
+    /**
+     * @brief Container holding the elements, drawn from the 64-byte aligned memory pool.
+     */
+    using Storage = std::vector<T, pool::Allocator<T>>;
+
     /**
      * @brief Deleted default constructor.
      */
@@ -21,7 +40,7 @@ public:
      * @param init Initial value for all element (default = 0.0).
      * @throws std::invalid_argument if rows or cols are less than 1.
      */
-    explicit Matrix(int rows, int cols, double init = 0.0)
+    explicit Matrix(int rows, int cols, T init = T { 0 })
         : m_rows {validate_dimension(rows)}
         , m_cols {validate_dimension(cols)}
         , m_data(
@@ -34,11 +53,11 @@ public:
      * @brief Constructs a matrix with the given dimensions and data.
      * @param rows Number of rows.
      * @param cols Number of columns.
-     * @param data Vector containing the matrix data.
+     * @param data Storage containing the matrix data.
      * @throws std::invalid_argument if rows or cols are less than 1 
      * or if the size of data does not match the specified dimensions.
      */
-    explicit Matrix(int rows, int cols, std::vector<double>&& data)
+    explicit Matrix(int rows, int cols, Storage&& data)
         : m_rows {validate_dimension(rows)}
         , m_cols {validate_dimension(cols)}
         , m_data {std::move(data)} 
@@ -48,6 +67,47 @@ public:
         }
     }
 
+    /**
+     * @brief Constructs a zero-filled matrix whose storage comes from the given allocator.
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @param allocator Allocator of the storage (pool or arena).
+     * @throws std::invalid_argument if rows or cols are less than 1.
+     */
+    explicit Matrix(int rows, int cols, const pool::Allocator<T>& allocator)
+        : m_rows {validate_dimension(rows)}
+        , m_cols {validate_dimension(cols)}
+        , m_data(static_cast<size_t>(rows) * static_cast<size_t>(cols), allocator)
+    {}
+
+    /**
+     * @brief Constructs a temporary matrix drawn from the arena of the current pool::ArenaScope.
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @return Zero-filled matrix; it uses the pool when no arena scope is open.
+     * @throws std::invalid_argument if rows or cols are less than 1.
+     * @note The matrix (and anything moved from it) must not outlive the scope. Copies are
+     * drawn from the pool, so copying a result out of the scope is safe.
+     */
+    [[nodiscard]] static Matrix scratch(int rows, int cols) {
+        return Matrix { rows, cols, pool::Allocator<T> { pool::current_arena() } };
+    }
+
+    /**
+     * @brief Constructs a matrix holding a copy of the elements of a view.
+     * @param view The view to copy.
+     * @throws std::invalid_argument if the view is empty.
+     */
+    explicit Matrix(const MatrixView<T>& view);
+
+    /**
+     * @brief Constructs a matrix by evaluating a lazy element-wise expression.
+     * @param expr The expression to evaluate.
+     */
+    template <expression::Node E>
+        requires std::same_as<typename E::value_type, T>
+    Matrix(const E& expr);
+
     /**
      * @brief Default destructor.
      */
@@ -87,6 +147,16 @@ public:
         return *this;
     }
 
+    /**
+     * @brief Evaluates a lazy element-wise expression into this matrix.
+     * @param expr The expression to evaluate.
+     * @return Reference to this matrix after assignment.
+     * @note The existing storage is reused when the shapes match, and the expression may refer to this matrix.
+     */
+    template <expression::Node E>
+        requires std::same_as<typename E::value_type, T>
+    Matrix& operator=(const E& expr);
+
     /**
      * @brief Returns the number of rows in the matrix.
      * @return Number of rows.
@@ -105,6 +175,13 @@ public:
      */
     [[nodiscard]] constexpr std::pair<int, int> shape() const noexcept;
 
+    /**
+     * @brief Returns a view of all the elements of the matrix.
+     * @return View of the matrix.
+     * @note Slicing the view instead of the matrix avoids copying the elements.
+     */
+    [[nodiscard]] MatrixView<T> view() const noexcept;
+
     /**
      * @brief Returns a row of the matrix as a new Matrix object.
      * @param index Index of the row to return.
@@ -161,7 +238,7 @@ public:
      * @return Reference to the element at the specified position.
      * @note This method does not perform bounds checking.
      */
-    [[nodiscard]] double& operator[](int row, int col) noexcept;
+    [[nodiscard]] T& operator[](int row, int col) noexcept;
 
     /**
      * @brief Accesses an element at the specified row and column indices (const version).
@@ -170,7 +247,7 @@ public:
      * @return Const reference to the element at the specified position.
      * @note This method does not perform bounds checking.
      */
-    [[nodiscard]] const double& operator[](int row, int col) const noexcept;
+    [[nodiscard]] const T& operator[](int row, int col) const noexcept;
 
     /**
      * @brief Accesses an element at the specified row and column indices with bounds checking.
@@ -179,7 +256,7 @@ public:
      * @return Reference to the element at the specified position.
      * @throws std::out_of_range if the row or column index is out of bounds
      */
-    [[nodiscard]] double& at(int row, int col);
+    [[nodiscard]] T& at(int row, int col);
 
     /**
      * @brief Accesses an element at the specified row and column indices with bounds checking (const version).
@@ -188,13 +265,38 @@ public:
      * @return Const reference to the element at the specified position.
      * @throws std::out_of_range if the row or column index is out of bounds
      */
-    [[nodiscard]] const double& at(int row, int col) const;
+    [[nodiscard]] const T& at(int row, int col) const;
 
     /**
      * @brief Fills the matrix with the specified value.
      * @param value Value to fill the matrix with.
      */
-    void fill(double value) noexcept;
+    void fill(T value) noexcept;
+
+    /**
+     * @brief Changes the shape of the matrix, reusing the existing storage whenever it is large enough.
+     * @param rows New number of rows.
+     * @param cols New number of columns.
+     * @throws std::invalid_argument if rows or cols are less than 1.
+     * @note The element values are unspecified after a shape change.
+     */
+    void resize(int rows, int cols);
+
+    /**
+     * @brief Copies the elements of a view into this matrix, reusing the existing storage when possible.
+     * @param view The view to copy.
+     * @note The view must not overlap this matrix.
+     */
+    void assign(const MatrixView<T>& view);
+
+    /**
+     * @brief Copies the elements of a matrix of another element type into this matrix, converting each element.
+     * @param other The matrix to copy.
+     * @note The existing storage is reused when possible.
+     */
+    template <typename U>
+        requires (!std::same_as<U, T>)
+    void assign(const Matrix<U>& other);
 
     /**
      * @brief Adds another matrix to this matrix.
@@ -202,7 +304,7 @@ public:
      * @return Reference to this matrix after addition.
      * @throws std::invalid_argument if the dimensions of the matrices do not match.
      */
-    Matrix& operator+=(const Matrix& rhs);
+    Matrix& operator+=(const MatrixView<T>& rhs);
 
     /**
      * @brief Subtracts another matrix from this matrix.
@@ -210,7 +312,27 @@ public:
      * @return Reference to this matrix after subtraction.
      * @throws std::invalid_argument if the dimensions of the matrices do not match.
      */
-    Matrix& operator-=(const Matrix& rhs);
+    Matrix& operator-=(const MatrixView<T>& rhs);
+
+    /**
+     * @brief Adds a lazy element-wise expression to this matrix in a single pass.
+     * @param expr The expression to add.
+     * @return Reference to this matrix after addition.
+     * @throws std::invalid_argument if the dimensions do not match.
+     */
+    template <expression::Node E>
+        requires std::same_as<typename E::value_type, T>
+    Matrix& operator+=(const E& expr);
+
+    /**
+     * @brief Subtracts a lazy element-wise expression from this matrix in a single pass.
+     * @param expr The expression to subtract.
+     * @return Reference to this matrix after subtraction.
+     * @throws std::invalid_argument if the dimensions do not match.
+     */
+    template <expression::Node E>
+        requires std::same_as<typename E::value_type, T>
+    Matrix& operator-=(const E& expr);
 
     /**
      * @brief Multiplies this matrix by a scalar.
@@ -218,7 +340,7 @@ public:
      * @return Reference to this matrix after multiplication.
      * @note This operation is performed element-wise.
      */
-    Matrix& operator*=(double scalar) noexcept;
+    Matrix& operator*=(T scalar) noexcept;
 
     /**
      * @brief Divides this matrix by a scalar.
@@ -227,7 +349,7 @@ public:
      * @throws std::invalid_argument if the scalar is zero.
      * @note This operation is performed element-wise.
      */
-    Matrix& operator/=(double scalar);
+    Matrix& operator/=(T scalar);
 
     /**
      * @brief Negates this matrix.
@@ -244,7 +366,9 @@ public:
      * @note Two matrices are considered equal if they have the same dimensions and 
      * all corresponding elements are equal.
      */
-    friend bool operator==(const Matrix& lhs, const Matrix& rhs) noexcept;
+    friend bool operator==(const Matrix& lhs, const Matrix& rhs) noexcept {
+        return lhs.m_rows == rhs.m_rows && lhs.m_cols == rhs.m_cols && lhs.m_data == rhs.m_data;
+    }
 
     /**
      * @brief Compares two matrices for inequality.
@@ -254,7 +378,9 @@ public:
      * @note Two matrices are considered not equal if they differ in dimensions or 
      * any corresponding elements are not equal.
      */
-    friend bool operator!=(const Matrix& lhs, const Matrix& rhs) noexcept;
+    friend bool operator!=(const Matrix& lhs, const Matrix& rhs) noexcept {
+        return !(lhs == rhs);
+    }
 
     /**
      * @brief Flattens the matrix into a single row or column.
@@ -269,13 +395,29 @@ public:
      */
     [[nodiscard]] Matrix transpose() const;
 
+    /**
+     * @brief Transposes the matrix in place.
+     * @details Square matrices swap pairs of register tiles across the diagonal without any
+     * extra storage; other shapes are transposed from a scratch copy into the same storage.
+     */
+    void transpose_in_place();
+
     /**
      * @brief Returns a new matrix that is the Hadamard product of this matrix and another matrix.
      * @param matrix The matrix to multiply with.
      * @return A new Matrix object containing the Hadamard product.
      * @throws std::invalid_argument if the dimensions of the matrices do not match.
      */
-    [[nodiscard]] Matrix hadamard(const Matrix& matrix) const;
+    [[nodiscard]] Matrix hadamard(const MatrixView<T>& matrix) const;
+
+    /**
+     * @brief Returns the lazy Hadamard product of this matrix and another matrix or expression.
+     * @param rhs The operand to multiply with.
+     * @return Expression of the element-wise product, evaluated when assigned to a Matrix.
+     * @throws std::invalid_argument if the dimensions do not match.
+     */
+    template <expression::Operand E>
+    [[nodiscard]] auto hadamard(const E& rhs) const;
 
     /**
      * @brief Multiplies this matrix by another matrix.
@@ -283,7 +425,25 @@ public:
      * @return A new Matrix object containing the product.
      * @throws std::invalid_argument if the inner dimensions of the matrices do not match.
      */
-    [[nodiscard]] Matrix matmul(const Matrix& matrix) const;
+    [[nodiscard]] Matrix matmul(const MatrixView<T>& matrix) const;
+
+    /**
+     * @brief Multiplies the transpose of this matrix by another matrix (this^T * matrix).
+     * @param matrix The matrix to multiply with.
+     * @return A new Matrix object containing the product.
+     * @throws std::invalid_argument if the number of rows of both matrices do not match.
+     * @note The transpose is read in place, without building a transposed copy.
+     */
+    [[nodiscard]] Matrix matmul_tn(const MatrixView<T>& matrix) const;
+
+    /**
+     * @brief Multiplies this matrix by the transpose of another matrix (this * matrix^T).
+     * @param matrix The matrix whose transpose to multiply with.
+     * @return A new Matrix object containing the product.
+     * @throws std::invalid_argument if the number of columns of both matrices do not match.
+     * @note The transpose is read in place, without building a transposed copy.
+     */
+    [[nodiscard]] Matrix matmul_nt(const MatrixView<T>& matrix) const;
 
     /**
      * @brief Returns a new matrix that is the Hadamard division of this matrix by another matrix.
@@ -293,7 +453,7 @@ public:
      * or if any element in the other matrix is zero.
      * @note This operation divides each element of this matrix by the corresponding element of the other matrix.
      */
-    [[nodiscard]] Matrix hadamard_div(const Matrix& matrix) const;
+    [[nodiscard]] Matrix hadamard_div(const MatrixView<T>& matrix) const;
 
     /**
      * @brief Computes the average of each row in the matrix.
@@ -311,7 +471,8 @@ public:
      * @brief Applies a function to each element of the matrix and returns a new matrix with the results.
      * @param f The function to apply to each element.
      * @return A new Matrix object containing the results of applying the function.
-     * @note The function should take a double and return a double.
+     * @note The function should take a T and return a T, and must be safe
+     * to call concurrently since large matrices are split across the thread pool.
      */
     template <typename Function>
     [[nodiscard]] Matrix apply(Function&& f) const;
@@ -327,9 +488,9 @@ private:
     int m_cols;
 
     /**
-     * @brief Vector containing the matrix data in row-major order.
+     * @brief Storage containing the matrix data in row-major order.
      */
-    std::vector<double> m_data;
+    Storage m_data;
 
     /**
      * @brief Validates the dimension of a matrix.
@@ -356,36 +517,26 @@ private:
     [[nodiscard]] int validate_col(int col) const;
 
     /**
-     * @brief Validates a range of rows.
-     * @param start Starting index of the range (inclusive).
-     * @param end Ending index of the range (exclusive).
-     * @throws std::out_of_range if the range is invalid or out of bounds.
-     * @throws std::invalid_argument if start is greater than or equal to end.
-     */
-    void validate_row_range(int start, int end) const;
-
-    /**
-     * @brief Validates a range of columns.
-     * @param start Starting index of the range (inclusive).
-     * @param end Ending index of the range (exclusive).
-     * @throws std::out_of_range if the range is invalid or out of bounds.
-     * @throws std::invalid_argument if start is greater than or equal to end.
+     * @brief Checks if the dimensions of two matrices match.
+     * @param other The other matrix to compare against.
+     * @throws std::invalid_argument if the dimensions do not match.
      */
-    void validate_col_range(int start, int end) const;
+    void check_matching_dimensions(const MatrixView<T>& other) const;
 
     /**
-     * @brief Checks if the dimensions of two matrices match.
-     * @param other The other matrix to compare against.
+     * @brief Checks if this matrix has the given dimensions.
+     * @param rows The expected number of rows.
+     * @param cols The expected number of columns.
      * @throws std::invalid_argument if the dimensions do not match.
      */
-    void check_matching_dimensions(const Matrix& other) const;
+    void check_matching_dimensions(int rows, int cols) const;
 
     /**
      * @brief Checks if the dimensions of two matrices match for element-wise operations.
      * @param other The other matrix to compare against.
      * @throws std::invalid_argument if the dimensions do not match.
      */
-    void check_mult_dimensions(const Matrix& other) const;
+    void check_mult_dimensions(const MatrixView<T>& other) const;
 
     /**
      * @brief Computes the index in the data vector for the given row and column.
@@ -396,46 +547,133 @@ private:
     [[nodiscard]] constexpr std::size_t index(int row, int col) const noexcept;
 };
 
-inline constexpr int Matrix::rows() const noexcept {
+template <typename T>
+inline constexpr int Matrix<T>::rows() const noexcept {
     return m_rows;
 }
 
-inline constexpr int Matrix::cols() const noexcept {
+template <typename T>
+inline constexpr int Matrix<T>::cols() const noexcept {
     return m_cols;
 }
 
-inline constexpr std::pair<int, int> Matrix::shape() const noexcept {
+template <typename T>
+inline constexpr std::pair<int, int> Matrix<T>::shape() const noexcept {
     return std::pair<int, int> {m_rows, m_cols};
 }
 
-inline double& Matrix::operator[](int row, int col) noexcept {
+template <typename T>
+inline T& Matrix<T>::operator[](int row, int col) noexcept {
     return m_data[index(row, col)];
 }
 
-inline const double& Matrix::operator[](int row, int col) const noexcept { 
+template <typename T>
+inline const T& Matrix<T>::operator[](int row, int col) const noexcept { 
     return m_data[index(row, col)];
 }
 
-inline double& Matrix::at(int row, int col) {
+template <typename T>
+inline T& Matrix<T>::at(int row, int col) {
     return m_data[index(validate_row(row), validate_col(col))];
 }
 
-inline const double& Matrix::at(int row, int col) const {
+template <typename T>
+inline const T& Matrix<T>::at(int row, int col) const {
     return m_data[index(validate_row(row), validate_col(col))];
 }
 
-inline constexpr size_t Matrix::index(int row, int col) const noexcept {
+template <typename T>
+inline constexpr size_t Matrix<T>::index(int row, int col) const noexcept {
     return static_cast<size_t>(row) 
         * static_cast<size_t>(m_cols) 
         + static_cast<size_t>(col);
 }
 
-template <typename Function>
-inline Matrix Matrix::apply(Function&& f) const {
-    Matrix result { *this };
-    for (auto& x : result.m_data) {
-        x = std::forward<Function>(f)(x);
+template <typename T>
+inline MatrixView<T>::MatrixView(const Matrix<T>& matrix) noexcept
+    : MatrixView(&matrix[0, 0], matrix.rows(), matrix.cols(), matrix.cols(), 1)
+{}
+
+template <typename T>
+inline MatrixView<T> Matrix<T>::view() const noexcept {
+    return MatrixView<T> {*this};
+}
+
+template <typename T>
+inline expression::Leaf<T>::Leaf(const Matrix<T>& matrix) noexcept
+    : m_data {&matrix[0, 0]}
+    , m_rows {matrix.rows()}
+    , m_cols {matrix.cols()}
+{}
+
+template <typename T>
+template <expression::Node E>
+    requires std::same_as<typename E::value_type, T>
+inline Matrix<T>::Matrix(const E& expr)
+    : Matrix(expr.rows(), expr.cols())
+{
+    expression::evaluate(expr, m_data.data());
+}
+
+template <typename T>
+template <expression::Node E>
+    requires std::same_as<typename E::value_type, T>
+inline Matrix<T>& Matrix<T>::operator=(const E& expr) {
+    if (m_rows != expr.rows() || m_cols != expr.cols()) {
+        return *this = Matrix { expr };
     }
+    expression::evaluate(expr, m_data.data());
+    return *this;
+}
+
+template <typename T>
+template <expression::Node E>
+    requires std::same_as<typename E::value_type, T>
+inline Matrix<T>& Matrix<T>::operator+=(const E& expr) {
+    check_matching_dimensions(expr.rows(), expr.cols());
+    expression::evaluate<expression::Add>(expr, m_data.data());
+    return *this;
+}
+
+template <typename T>
+template <expression::Node E>
+    requires std::same_as<typename E::value_type, T>
+inline Matrix<T>& Matrix<T>::operator-=(const E& expr) {
+    check_matching_dimensions(expr.rows(), expr.cols());
+    expression::evaluate<expression::Sub>(expr, m_data.data());
+    return *this;
+}
+
+template <typename T>
+template <expression::Operand E>
+inline auto Matrix<T>::hadamard(const E& rhs) const {
+    return expression::Leaf<T> { *this }.hadamard(rhs);
+}
+
+template <typename T>
+template <typename U>
+    requires (!std::same_as<U, T>)
+inline void Matrix<T>::assign(const Matrix<U>& other) {
+    resize(other.rows(), other.cols());
+    const U* src = &other[0, 0];
+    parallel::for_each_chunk(m_data.size(), parallel::GRAIN, [&](size_t first, size_t last) {
+        for (size_t idx { first }; idx < last; ++idx) {
+            m_data[idx] = static_cast<T>(src[idx]);
+        }
+    });
+}
+
+template <typename T>
+template <typename Function>
+inline Matrix<T> Matrix<T>::apply(Function&& f) const {
+    return view().apply(std::forward<Function>(f));
+}
+
+template <typename T>
+template <typename Function>
+inline Matrix<T> MatrixView<T>::apply(Function&& f) const {
+    Matrix<T> result { m_rows, m_cols };
+    apply_into(result, *this, std::forward<Function>(f));
     return result;
 }
 
@@ -446,7 +684,8 @@ inline Matrix Matrix::apply(Function&& f) const {
  * @return A new Matrix object containing the result of the addition.
  * @throws std::invalid_argument if the dimensions of the matrices do not match.
  */
-[[nodiscard]] Matrix operator+(Matrix lhs, const Matrix& rhs);
+template <typename T>
+[[nodiscard]] Matrix<T> operator+(Matrix<T> lhs, const ViewArg<T>& rhs);
 
 /**
  * @brief Subtracts two matrices element-wise.
@@ -455,23 +694,8 @@ inline Matrix Matrix::apply(Function&& f) const {
  * @return A new Matrix object containing the result of the subtraction.
  * @throws std::invalid_argument if the dimensions of the matrices do not match.
  */
-[[nodiscard]] Matrix operator-(Matrix lhs, const Matrix& rhs);
-
-/**
- * @brief Multiplies a matrix by a scalar.
- * @param matrix The matrix to multiply.
- * @param scalar The scalar to multiply by.
- * @return A new Matrix object containing the result of the multiplication.
- */
-[[nodiscard]] Matrix operator*(Matrix matrix, double scalar);
-
-/**
- * @brief Multiplies a scalar by a matrix.
- * @param scalar The scalar to multiply by.
- * @param matrix The matrix to multiply.
- * @return A new Matrix object containing the result of the multiplication.
- */
-[[nodiscard]] Matrix operator*(double scalar, Matrix matrix);
+template <typename T>
+[[nodiscard]] Matrix<T> operator-(Matrix<T> lhs, const ViewArg<T>& rhs);
 
 /**
  * @brief Divides a matrix by a scalar.
@@ -480,7 +704,8 @@ inline Matrix Matrix::apply(Function&& f) const {
  * @return A new Matrix object containing the result of the division.
  * @throws std::invalid_argument if the scalar is zero.
  */
-[[nodiscard]] Matrix operator/(Matrix matrix, double scalar);
+template <typename T>
+[[nodiscard]] Matrix<T> operator/(Matrix<T> matrix, std::type_identity_t<T> scalar);
 
 /**
  * @brief Multiplies two matrices using matrix multiplication.
@@ -489,7 +714,128 @@ inline Matrix Matrix::apply(Function&& f) const {
  * @return A new Matrix object containing the result of the multiplication.
  * @throws std::invalid_argument if the inner dimensions of the matrices do not match.
  */
-[[nodiscard]] Matrix operator*(const Matrix& lhs, const Matrix& rhs);
+template <typename T>
+[[nodiscard]] Matrix<T> operator*(const MatrixView<T>& lhs, const MatrixView<T>& rhs);
+
+/**
+ * @brief Multiplies a matrix by a view using matrix multiplication.
+ * @see operator*(const MatrixView<T>&, const MatrixView<T>&)
+ */
+template <typename T>
+[[nodiscard]] Matrix<T> operator*(const Matrix<T>& lhs, const MatrixView<T>& rhs) {
+    return lhs.view() * rhs;
+}
+
+/**
+ * @brief Multiplies a view by a matrix using matrix multiplication.
+ * @see operator*(const MatrixView<T>&, const MatrixView<T>&)
+ */
+template <typename T>
+[[nodiscard]] Matrix<T> operator*(const MatrixView<T>& lhs, const Matrix<T>& rhs) {
+    return lhs * rhs.view();
+}
+
+/**
+ * @brief Multiplies two matrices using matrix multiplication.
+ * @see operator*(const MatrixView<T>&, const MatrixView<T>&)
+ */
+template <typename T>
+[[nodiscard]] Matrix<T> operator*(const Matrix<T>& lhs, const Matrix<T>& rhs) {
+    return lhs.view() * rhs.view();
+}
+
+/**
+ * @brief Multiplies two matrices into a caller-owned destination.
+ * @param out Destination, resized to (lhs.rows() x rhs.cols()) only if its shape differs.
+ * @param lhs The left-hand side matrix (pass a transposed view to multiply by a transpose).
+ * @param rhs The right-hand side matrix.
+ * @throws std::invalid_argument if the inner dimensions of the matrices do not match.
+ * @note out must not overlap lhs or rhs.
+ */
+template <typename T>
+void matmul_into(Matrix<T>& out, const ViewArg<T>& lhs, const ViewArg<T>& rhs);
+
+/**
+ * @brief Multiplies two matrices into a caller-owned destination, adding a bias column and applying an
+ * element-wise activation to every tile of the product before it leaves the GEMM micro-kernel.
+ * @param out Destination of lhs * rhs + bias, resized to (lhs.rows() x rhs.cols()) only if its shape differs.
+ * @param activated Destination of activation(out), resized likewise; may be out itself to keep only the activation.
+ * @param lhs The left-hand side matrix (pass a transposed view to multiply by a transpose).
+ * @param rhs The right-hand side matrix.
+ * @param bias Column of lhs.rows() values added to every column of the product.
+ * @param activation The element-wise function applied after the bias.
+ * @throws std::invalid_argument if the inner dimensions of the matrices do not match or bias is not a lhs.rows() x 1 column.
+ * @note Neither out nor activated may overlap lhs or rhs.
+ */
+template <typename T>
+void matmul_into(
+    Matrix<T>& out, Matrix<T>& activated,
+    const ViewArg<T>& lhs, const ViewArg<T>& rhs,
+    const ViewArg<T>& bias, gemm::Activation activation
+);
+
+/**
+ * @brief Computes the Hadamard product of two matrices into a caller-owned destination.
+ * @param out Destination, resized to the shape of the operands only if its shape differs.
+ * @param lhs The left-hand side matrix.
+ * @param rhs The right-hand side matrix.
+ * @throws std::invalid_argument if the dimensions of the matrices do not match.
+ * @note out may be one of the operands, which turns the operation into an in-place product.
+ */
+template <typename T>
+void hadamard_into(Matrix<T>& out, const ViewArg<T>& lhs, const ViewArg<T>& rhs);
+
+/**
+ * @brief Transposes a matrix into a caller-owned destination.
+ * @param out Destination, resized to (matrix.cols() x matrix.rows()) only if its shape differs.
+ * @param matrix The matrix to transpose.
+ * @note out must not overlap matrix.
+ */
+template <typename T>
+void transpose_into(Matrix<T>& out, const ViewArg<T>& matrix);
+
+/**
+ * @brief Applies a function to each element of a matrix, writing the results into a caller-owned destination.
+ * @param out Destination, resized to the shape of the matrix only if its shape differs.
+ * @param matrix The matrix to read.
+ * @param f The function to apply to each element.
+ * @note out may be the matrix itself, which turns the operation into an in-place update.
+ */
+template <typename T, typename Function>
+void apply_into(Matrix<T>& out, const ViewArg<T>& matrix, Function&& f) {
+    const int rows = matrix.rows();
+    const int cols = matrix.cols();
+    if (out.view().data() != matrix.data()) {
+        out.resize(rows, cols);
+    }
+    T* dst = &out[0, 0];
+    if (matrix.is_contiguous()) {
+        const T* src = matrix.data();
+        parallel::for_each_chunk(static_cast<size_t>(rows) * static_cast<size_t>(cols), parallel::GRAIN,
+            [&](size_t first, size_t last) {
+                for (size_t idx { first }; idx < last; ++idx) {
+                    dst[idx] = f(src[idx]);
+                }
+            });
+        return;
+    }
+    parallel::for_each_chunk(static_cast<size_t>(rows), 1, [&](size_t first, size_t last) {
+        for (int row { static_cast<int>(first) }; row < static_cast<int>(last); ++row) {
+            for (int col { 0 }; col < cols; ++col) {
+                dst[static_cast<size_t>(row) * static_cast<size_t>(cols) + static_cast<size_t>(col)] = f(matrix[row, col]);
+            }
+        }
+    }, static_cast<size_t>(rows) * static_cast<size_t>(cols));
+}
+
+/**
+ * @brief Computes the average of each row of a matrix into a caller-owned destination.
+ * @param out Destination, resized to (matrix.rows() x 1) only if its shape differs.
+ * @param matrix The matrix to average.
+ * @note out must not overlap matrix.
+ */
+template <typename T>
+void row_avg_into(Matrix<T>& out, const ViewArg<T>& matrix);
 
 /**
  * @brief Outputs the matrix to an output stream.
@@ -497,4 +843,5 @@ inline Matrix Matrix::apply(Function&& f) const {
  * @param matrix The matrix to output.
  * @return The output stream after writing the matrix.
  */
-std::ostream& operator<<(std::ostream& out, const Matrix& matrix);
+template <typename T>
+std::ostream& operator<<(std::ostream& out, const Matrix<T>& matrix);
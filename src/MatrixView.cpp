@@ -0,0 +1,77 @@
+#include "Matrix.h"
+#include <format>
+#include <stdexcept>
+
+template <typename T>
+MatrixView<T> MatrixView<T>::row(int index) const {
+    validate_index(index, m_rows, "row");
+    return {m_data + index * m_row_stride, 1, m_cols, m_row_stride, m_col_stride};
+}
+
+template <typename T>
+MatrixView<T> MatrixView<T>::rows(int start, int end) const {
+    validate_range(start, end, m_rows, "row");
+    return {m_data + start * m_row_stride, end - start, m_cols, m_row_stride, m_col_stride};
+}
+
+template <typename T>
+MatrixView<T> MatrixView<T>::col(int index) const {
+    validate_index(index, m_cols, "col");
+    return {m_data + index * m_col_stride, m_rows, 1, m_row_stride, m_col_stride};
+}
+
+template <typename T>
+MatrixView<T> MatrixView<T>::cols(int start, int end) const {
+    validate_range(start, end, m_cols, "col");
+    return {m_data + start * m_col_stride, m_rows, end - start, m_row_stride, m_col_stride};
+}
+
+template <typename T>
+MatrixView<T> MatrixView<T>::slice(int row_start, int row_end, int col_start, int col_end) const {
+    return rows(row_start, row_end).cols(col_start, col_end);
+}
+
+template <typename T>
+MatrixView<T> MatrixView<T>::flatten(bool col) const {
+    if (!is_contiguous()) {
+        throw std::logic_error("cannot flatten a non-contiguous matrix view");
+    }
+    const int size = m_rows * m_cols;
+    return col
+        ? MatrixView<T> {m_data, size, 1, 1, 1}
+        : MatrixView<T> {m_data, 1, size, size, 1};
+}
+
+template <typename T>
+MatrixView<T> MatrixView<T>::transpose() const noexcept {
+    return {m_data, m_cols, m_rows, m_col_stride, m_row_stride};
+}
+
+template <typename T>
+void MatrixView<T>::validate_index(int index, int size, const char* name) {
+    if (index < 0 || index >= size) {
+        throw std::out_of_range(std::format(
+            "{} index ({}) is out of bounds [0, {}]",
+            name, index, size - 1
+        ));
+    }
+}
+
+template <typename T>
+void MatrixView<T>::validate_range(int start, int end, int size, const char* name) {
+    if (start >= end) {
+        throw std::invalid_argument(std::format(
+            "invalid range specification [{},{}]",
+            start, end
+        ));
+    }
+    if (start < 0 || end > size) {
+        throw std::out_of_range(std::format(
+            "{} range [{},{}] is out of bounds [0, {}]",
+            name, start, end, size - 1
+        ));
+    }
+}
+
+template class MatrixView<float>;
+template class MatrixView<double>;
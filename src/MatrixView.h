@@ -0,0 +1,269 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+template <typename T>
+class Matrix;
+
+/**
+ * @class MatrixView
+ * @brief Non-owning, read-only view over a 2D block of scalars.
+ * @details A view is a pointer together with a shape and a stride per dimension, so slicing
+ * rows or columns and transposing only produce a new view and never copy the elements.
+ * Every Matrix converts implicitly to a view of all its elements.
+ * @tparam T Element type (float or double).
+ * @note The viewed storage must outlive the view.
+ */
+template <typename T>
+class MatrixView {
+public:
+    /**
+     * @brief Type of the elements.
+     */
+    using value_type = T;
+
+    /**
+     * @brief Constructs an empty view (0 x 0) that does not refer to any data.
+     */
+    MatrixView() = default;
+
+    /**
+     * @brief Constructs a view over all the elements of a matrix.
+     * @param matrix The matrix to view.
+     */
+    MatrixView(const Matrix<T>& matrix) noexcept;
+
+    /**
+     * @brief Constructs a view over raw data.
+     * @param data Pointer to the element at (0, 0).
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @param row_stride Distance between consecutive rows.
+     * @param col_stride Distance between consecutive columns.
+     */
+    MatrixView(const T* data, int rows, int cols, std::ptrdiff_t row_stride, std::ptrdiff_t col_stride) noexcept
+        : m_data {data}
+        , m_rows {rows}
+        , m_cols {cols}
+        , m_row_stride {row_stride}
+        , m_col_stride {col_stride}
+    {}
+
+    /**
+     * @brief Returns the number of rows in the view.
+     * @return Number of rows.
+     */
+    [[nodiscard]] constexpr int rows() const noexcept;
+
+    /**
+     * @brief Returns the number of columns in the view.
+     * @return Number of columns.
+     */
+    [[nodiscard]] constexpr int cols() const noexcept;
+
+    /**
+     * @brief Returns the shape of the view as a pair (rows, cols).
+     * @return Pair containing the number of rows and columns.
+     */
+    [[nodiscard]] constexpr std::pair<int, int> shape() const noexcept;
+
+    /**
+     * @brief Returns the distance between consecutive rows.
+     * @return Row stride in elements.
+     */
+    [[nodiscard]] constexpr std::ptrdiff_t row_stride() const noexcept;
+
+    /**
+     * @brief Returns the distance between consecutive columns.
+     * @return Column stride in elements.
+     */
+    [[nodiscard]] constexpr std::ptrdiff_t col_stride() const noexcept;
+
+    /**
+     * @brief Returns a pointer to the element at (0, 0).
+     * @return Pointer to the first element.
+     */
+    [[nodiscard]] constexpr const T* data() const noexcept;
+
+    /**
+     * @brief Checks whether the elements are stored contiguously in row-major order.
+     * @return True if the view covers a contiguous row-major block.
+     */
+    [[nodiscard]] constexpr bool is_contiguous() const noexcept;
+
+    /**
+     * @brief Accesses an element at the specified row and column indices.
+     * @param row Row index.
+     * @param col Column index.
+     * @return Const reference to the element at the specified position.
+     * @note This method does not perform bounds checking.
+     */
+    [[nodiscard]] const T& operator[](int row, int col) const noexcept;
+
+    /**
+     * @brief Returns a view of a single row.
+     * @param index Index of the row.
+     * @return View of the specified row.
+     * @throws std::out_of_range if the index is out of bounds.
+     */
+    [[nodiscard]] MatrixView row(int index) const;
+
+    /**
+     * @brief Returns a view of the rows from start to end (exclusive).
+     * @param start Starting index of the rows (inclusive).
+     * @param end Ending index of the rows (exclusive).
+     * @return View of the specified rows.
+     * @throws std::out_of_range if the range is out of bounds.
+     * @throws std::invalid_argument if start is greater than or equal to end.
+     */
+    [[nodiscard]] MatrixView rows(int start, int end) const;
+
+    /**
+     * @brief Returns a view of a single column.
+     * @param index Index of the column.
+     * @return View of the specified column.
+     * @throws std::out_of_range if the index is out of bounds.
+     */
+    [[nodiscard]] MatrixView col(int index) const;
+
+    /**
+     * @brief Returns a view of the columns from start to end (exclusive).
+     * @param start Starting index of the columns (inclusive).
+     * @param end Ending index of the columns (exclusive).
+     * @return View of the specified columns.
+     * @throws std::out_of_range if the range is out of bounds.
+     * @throws std::invalid_argument if start is greater than or equal to end.
+     */
+    [[nodiscard]] MatrixView cols(int start, int end) const;
+
+    /**
+     * @brief Returns a view of the block defined by the specified row and column ranges.
+     * @param row_start Starting index of the rows (inclusive).
+     * @param row_end Ending index of the rows (exclusive).
+     * @param col_start Starting index of the columns (inclusive).
+     * @param col_end Ending index of the columns (exclusive).
+     * @return View of the specified block.
+     * @throws std::out_of_range if the ranges are out of bounds.
+     * @throws std::invalid_argument if a start index is greater than or equal to its end index.
+     */
+    [[nodiscard]] MatrixView slice(int row_start, int row_end, int col_start, int col_end) const;
+
+    /**
+     * @brief Returns a view of the same elements as a single row or column.
+     * @param col If true, flattens to a single column; if false, to a single row.
+     * @return Flattened view.
+     * @throws std::logic_error if the view is not contiguous.
+     */
+    [[nodiscard]] MatrixView flatten(bool col=true) const;
+
+    /**
+     * @brief Returns the transposed view, obtained by swapping the shape and strides.
+     * @return Transposed view.
+     */
+    [[nodiscard]] MatrixView transpose() const noexcept;
+
+    /**
+     * @brief Applies a function to each element and returns a new matrix with the results.
+     * @param f The function to apply to each element.
+     * @return A new Matrix object containing the results of applying the function.
+     * @note The function should take a T and return a T, and must be safe
+     * to call concurrently since large views are split across the thread pool.
+     */
+    template <typename Function>
+    [[nodiscard]] Matrix<T> apply(Function&& f) const;
+private:
+    /**
+     * @brief Pointer to the element at (0, 0).
+     */
+    const T* m_data = nullptr;
+
+    /**
+     * @brief Number of rows in the view.
+     */
+    int m_rows = 0;
+
+    /**
+     * @brief Number of columns in the view.
+     */
+    int m_cols = 0;
+
+    /**
+     * @brief Distance between consecutive rows.
+     */
+    std::ptrdiff_t m_row_stride = 0;
+
+    /**
+     * @brief Distance between consecutive columns.
+     */
+    std::ptrdiff_t m_col_stride = 0;
+
+    /**
+     * @brief Validates an index against a dimension.
+     * @param index The index to validate.
+     * @param size Size of the dimension.
+     * @param name Name of the dimension used in error messages.
+     * @throws std::out_of_range if the index is out of bounds.
+     */
+    static void validate_index(int index, int size, const char* name);
+
+    /**
+     * @brief Validates a range of indices against a dimension.
+     * @param start Starting index of the range (inclusive).
+     * @param end Ending index of the range (exclusive).
+     * @param size Size of the dimension.
+     * @param name Name of the dimension used in error messages.
+     * @throws std::out_of_range if the range is out of bounds.
+     * @throws std::invalid_argument if start is greater than or equal to end.
+     */
+    static void validate_range(int start, int end, int size, const char* name);
+};
+
+template <typename T>
+inline constexpr int MatrixView<T>::rows() const noexcept {
+    return m_rows;
+}
+
+template <typename T>
+inline constexpr int MatrixView<T>::cols() const noexcept {
+    return m_cols;
+}
+
+template <typename T>
+inline constexpr std::pair<int, int> MatrixView<T>::shape() const noexcept {
+    return std::pair<int, int> {m_rows, m_cols};
+}
+
+template <typename T>
+inline constexpr std::ptrdiff_t MatrixView<T>::row_stride() const noexcept {
+    return m_row_stride;
+}
+
+template <typename T>
+inline constexpr std::ptrdiff_t MatrixView<T>::col_stride() const noexcept {
+    return m_col_stride;
+}
+
+template <typename T>
+inline constexpr const T* MatrixView<T>::data() const noexcept {
+    return m_data;
+}
+
+template <typename T>
+inline constexpr bool MatrixView<T>::is_contiguous() const noexcept {
+    return m_col_stride == 1 && (m_rows == 1 || m_row_stride == m_cols);
+}
+
+template <typename T>
+inline const T& MatrixView<T>::operator[](int row, int col) const noexcept {
+    return m_data[row * m_row_stride + col * m_col_stride];
+}
+
+/**
+ * @brief View parameter type that does not take part in template argument deduction.
+ * @details Functions writing into a Matrix<T> deduce T from their destination, so matrices
+ * and views can both be passed for the other operands through the implicit conversion.
+ */
+template <typename T>
+using ViewArg = std::type_identity_t<MatrixView<T>>;
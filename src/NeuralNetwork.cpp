@@ -1,79 +1,338 @@
 #include "NeuralNetwork.h"
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <concepts>
+#include <cstring>
+#include <format>
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <random>
+#include <type_traits>
+#include <utility>
 
 static std::mt19937 generator(std::random_device{}());
 
-NeuralNetwork::NeuralNetwork(const config::Network& config) {
+/**
+ * @brief Arena holding the temporaries of one training step or one prediction, reset when it ends.
+ */
+static thread_local pool::Arena step_arena;
+
+/**
+ * @brief Number of samples converted and predicted at once when evaluating a dataset.
+ */
+static constexpr int EVALUATION_BATCH = 1024;
+
+template <typename T, typename Master>
+NeuralNetwork<T, Master>::NeuralNetwork(const config::Network& config)
+    : loss {config.loss_type}
+    , parameters {config}
+{
+    const parameters::Slots<T> slots = parameters.slots();
+    layers.reserve(config.layers.size());
     int input = config.input_size;
     for (const auto& l : config.layers) {
-        layers.push_back({input, l.units, l.activation_type, l.initialization_type, config.optimizer, generator});
+        layers.emplace_back(input, l.units, l.activation_type, l.initialization_type, slots, generator);
         input = l.units;
     }
-    loss = config.loss_type;
-    regularization = config.regularization;
-    weight_decay = config.weight_decay;
+    /* Nothing before the input layer is trained, so the gradient with respect to the input is never read */
+    layers.front().set_input_gradient(false);
+    parameters.bind();
+}
+
+template <typename T, typename Master>
+NeuralNetwork<T, Master>::NeuralNetwork(const NeuralNetwork& other)
+    : loss {other.loss}
+    , parameters {other.parameters.layout()}
+    , epoch_loss {other.epoch_loss}
+{
+    /* The copies draw their matrices in the same order, so the buffers line up and are copied in one pass each */
+    const parameters::Slots<T> slots = parameters.slots();
+    layers.reserve(other.layers.size());
+    for (const auto& layer : other.layers) {
+        layers.emplace_back(layer, slots);
+    }
+    parameters.assign(other.parameters);
 }
 
-void NeuralNetwork::train(const Matrix& input, const Matrix& label, double learning_rate) {
-    Matrix a = input;
-    for (auto& layer : layers) {
-        a = std::move(layer.forward(a));
+template <typename T, typename Master>
+NeuralNetwork<T, Master>& NeuralNetwork<T, Master>::operator=(const NeuralNetwork& other) {
+    if (this == &other) {
+        return *this;
     }
+    if (!same_layers(other)) {
+        return *this = NeuralNetwork { other };
+    }
+    loss = other.loss;
+    epoch_loss = other.epoch_loss;
+    parameters.assign(other.parameters);
+    return *this;
+}
+
+template <typename T, typename Master>
+bool NeuralNetwork<T, Master>::same_layers(const NeuralNetwork& other) const noexcept {
+    if (layers.size() != other.layers.size() || !parameters.same_layout(other.parameters)) {
+        return false;
+    }
+    for (size_t i { 0 }; i < layers.size(); ++i) {
+        const Layer<T>& layer = layers[i];
+        const Layer<T>& theirs = other.layers[i];
+        if (layer.weights().rows() != theirs.weights().rows()
+            || layer.weights().cols() != theirs.weights().cols()
+            || layer.activation_type() != theirs.activation_type()
+            || layer.needs_input_gradient() != theirs.needs_input_gradient()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T, typename Master>
+void NeuralNetwork<T, Master>::train(const MatrixView<T>& input, const MatrixView<T>& label, double learning_rate) {
+    train_step(input, label, {}, learning_rate);
+}
+
+template <typename T, typename Master>
+void NeuralNetwork<T, Master>::train(const SparseMatrix<T>& input, const MatrixView<T>& label, double learning_rate) {
+    train_step(input, label, {}, learning_rate);
+}
+
+template <typename T, typename Master>
+bool NeuralNetwork<T, Master>::fused_loss() const noexcept {
+    return loss == loss::Type::CrossEntropy && layers.back().activation_type() == activation::Type::Softmax;
+}
+
+template <typename T, typename Master>
+template <typename Input>
+void NeuralNetwork<T, Master>::train_step(const Input& input, const MatrixView<T>& label, std::span<const int> classes, double learning_rate) {
+    pool::ArenaScope scope { step_arena };
 
-    auto[dz, batch_loss] = layers.back().loss(label, a, loss);
+    /* A softmax output trained on cross-entropy stops at its logits: the loss kernel applies the softmax itself */
+    const bool fused = fused_loss();
+    auto forward = [&](Layer<T>& layer, const auto& a_prev) -> MatrixView<T> {
+        return fused && &layer == &layers.back() ? layer.forward_logits(a_prev) : layer.forward(a_prev);
+    };
+
+    /* Every layer owns its output buffer, so the views cached by the next layer stay valid until backprop ends */
+    MatrixView<T> a = forward(layers.front(), input);
+    for (size_t i { 1 }; i < layers.size(); ++i) {
+        a = forward(layers[i], a);
+    }
+
+    if (fused && classes.empty()) {
+        loss::classes_into(batch_classes, label);
+        classes = batch_classes;
+    }
+    auto[dz, batch_loss] = fused ? layers.back().loss(classes) : layers.back().loss(label, a, loss);
     epoch_loss += batch_loss;
+    MatrixView<T> gradient = dz;
     for (int i = layers.size() - 2; i >= 0; i--) {
-        dz = std::move(layers[i].backward(dz));
+        gradient = layers[i].backward(gradient);
     }
 
-    for (auto& layer : layers) {
-        layer.update(learning_rate, regularization, weight_decay);
-    }
+    parameters.update(learning_rate);
+    step_arena_peak = std::max(step_arena_peak, scope.peak());
+}
+
+template <typename T, typename Master>
+void NeuralNetwork<T, Master>::fit(
+    const MatrixView<T>& input,
+    const MatrixView<T>& label,
+    const config::Training& config, 
+    std::optional<config::Validation<T>> validation
+) {
+    fit_epochs(input, label, config, std::move(validation));
 }
 
-void NeuralNetwork::fit(
-    const Matrix& input, 
-    const Matrix& label, 
+template <typename T, typename Master>
+void NeuralNetwork<T, Master>::fit(
+    const SparseMatrix<T>& input,
+    const MatrixView<T>& label,
     const config::Training& config, 
-    std::optional<config::Validation> validation
+    std::optional<config::Validation<T>> validation
 ) {
-    const int num_samples = input.cols();
+    fit_epochs(input, label, config, std::move(validation));
+}
+
+template <typename T, typename Master>
+void NeuralNetwork<T, Master>::fit(
+    const Dataset& dataset,
+    const config::Training& config, 
+    std::optional<config::Validation<T>> validation
+) {
+    fit_epochs(dataset, MatrixView<T> {}, config, std::move(validation));
+}
+
+template <typename T, typename Master>
+template <typename Input>
+void NeuralNetwork<T, Master>::fit_epochs(
+    const Input& input,
+    const MatrixView<T>& label,
+    const config::Training& config, 
+    std::optional<config::Validation<T>> validation
+) {
+    constexpr bool sparse = std::same_as<Input, SparseMatrix<T>>;
+    constexpr bool bytes = std::same_as<Input, Dataset>;
+    const int num_samples = [&] {
+        if constexpr (bytes) {
+            return input.samples();
+        } else {
+            return input.cols();
+        }
+    }();
     const int BATCH_PER_EPOCH = (num_samples + config.batch_size - 1) / config.batch_size;
 
     std::unique_ptr<NeuralNetwork> best_model;
     double best_accuracy = std::numeric_limits<double>::lowest();
     int patience = 0;
 
-    std::vector<int> order(num_samples);
-    std::iota(order.begin(), order.end(), 0);
+    /* Sample-major data is passed as transposed views (one sample per column, each column contiguous) */
+    const bool sample_major = [&] {
+        if constexpr (sparse) {
+            return false;
+        } else if constexpr (bytes) {
+            return true;
+        } else {
+            return input.row_stride() == 1 && input.col_stride() != 1;
+        }
+    }();
+    const bool labels_sample_major = [&] {
+        if constexpr (bytes) {
+            return false;
+        } else {
+            return label.row_stride() == 1 && label.col_stride() != 1;
+        }
+    }();
+
+    /* Two orders: workers gather the next epoch from one while the current epoch is trained on the other */
+    std::array<std::vector<int>, 2> orders;
+    for (std::vector<int>& order : orders) {
+        order.resize(num_samples);
+        std::iota(order.begin(), order.end(), 0);
+    }
 
+    /* The fused loss reads class indices, so the one-hot labels are converted once and never gathered */
+    const bool fused = fused_loss();
+    std::vector<int> classes;
+    if (fused) {
+        if constexpr (bytes) {
+            classes.assign(input.labels().begin(), input.labels().end());
+        } else {
+            loss::classes_into(classes, label);
+        }
+    }
+
+    /* A gathered batch, as handed over by the pipeline; sample-major data is gathered as rows */
+    struct Batch {
+        std::conditional_t<sparse, SparseMatrix<T>, Matrix<T>> inputs;
+        Matrix<T> labels;           ///< One-hot labels, gathered only when shuffled and not fused
+        std::vector<int> classes;   ///< Class indices, gathered only when fused
+    };
+
+    /* Unshuffled dense batches are contiguous column ranges passed as views: only the other cases are gathered */
+    std::optional<prefetch::Pipeline<Batch>> pipeline;
+    if (sparse || bytes || config.shuffle) {
+        auto make = [&] {
+            if constexpr (sparse) {
+                return Batch { SparseMatrix<T> { input.rows() }, Matrix<T> { label.rows(), 1 }, {} };
+            } else if constexpr (bytes) {
+                return Batch { Matrix<T> { input.features(), 1 }, Matrix<T> { input.classes(), 1 }, {} };
+            } else {
+                return Batch { Matrix<T> { input.rows(), 1 }, Matrix<T> { label.rows(), 1 }, {} };
+            }
+        };
+        auto fill = [&](Batch& batch, std::size_t index) {
+            const std::vector<int>& order = orders[index / BATCH_PER_EPOCH % 2];
+            const int start = static_cast<int>(index % BATCH_PER_EPOCH) * config.batch_size;
+            const int end = std::min(start + config.batch_size, num_samples);
+
+            batch.classes.clear();
+            if (fused) {
+                for (int i { start }; i < end; ++i) {
+                    batch.classes.push_back(classes[order[i]]);
+                }
+            }
+            if constexpr (bytes) {
+                input.samples_into(batch.inputs, order, start, end);
+                if (!fused) {
+                    input.labels_into(batch.labels, order, start, end);
+                }
+            } else {
+                if constexpr (sparse) {
+                    input.select_cols_into(batch.inputs, order, start, end);
+                } else if (sample_major) {
+                    NeuralNetwork::random_samples_into(batch.inputs, input, order, start, end);
+                } else {
+                    NeuralNetwork::random_cols_into(batch.inputs, input, order, start, end);
+                }
+                /* Unshuffled labels are passed as column ranges */
+                if (!fused && config.shuffle) {
+                    if (labels_sample_major) {
+                        NeuralNetwork::random_samples_into(batch.labels, label, order, start, end);
+                    } else {
+                        NeuralNetwork::random_cols_into(batch.labels, label, order, start, end);
+                    }
+                }
+            }
+        };
+        pipeline.emplace(config.prefetch, static_cast<std::size_t>(config.epochs) * BATCH_PER_EPOCH, make, fill);
+    }
+
+    if (config.shuffle) {
+        std::shuffle(orders[0].begin(), orders[0].end(), generator);
+    }
+    if (pipeline) {
+        pipeline->open(config.shuffle ? BATCH_PER_EPOCH : static_cast<std::size_t>(config.epochs) * BATCH_PER_EPOCH);
+    }
 
     for (int epoch { 0 }; epoch < config.epochs; ++epoch) {
         
         std::cout << "Epoch " << epoch+1 << " / " << config.epochs << '\n';
         epoch_loss = 0.0;        
+        step_arena_peak = 0;
 
         const double learning_rate = learning_rate::current(config.learning_rate, epoch);
 
-        if (config.shuffle) {
-            std::shuffle(order.begin(), order.end(), generator);
+        /* The order of the next epoch is the one no worker is reading: the previous epoch was fully consumed */
+        if (config.shuffle && pipeline) {
+            std::vector<int>& next_order = orders[(epoch + 1) % 2];
+            std::shuffle(next_order.begin(), next_order.end(), generator);
+            pipeline->open(static_cast<std::size_t>(epoch + 2) * BATCH_PER_EPOCH);
         }
 
         for (int start { 0 }; start < num_samples; start += config.batch_size) {
             int end = std::min(start + config.batch_size, num_samples);
 
-            Matrix batch_inputs = NeuralNetwork::random_cols(input, order, start, end);
-            Matrix batch_labels = NeuralNetwork::random_cols(label, order, start, end);
+            if constexpr (!sparse && !bytes) {
+                if (!pipeline) {
+                    batch_classes.clear();
+                    if (fused) {
+                        batch_classes.assign(classes.begin() + start, classes.begin() + end);
+                    }
+                    train_step(input.cols(start, end), label.cols(start, end), batch_classes, learning_rate);
+                    continue;
+                }
+            }
 
-            train(batch_inputs, batch_labels, learning_rate);
+            Batch& batch = pipeline->next();
+            const MatrixView<T> labels = !bytes && !config.shuffle ? label.cols(start, end)
+                : labels_sample_major ? batch.labels.view().transpose() : batch.labels.view();
+            if constexpr (sparse) {
+                train_step(batch.inputs, labels, batch.classes, learning_rate);
+            } else {
+                train_step(sample_major ? batch.inputs.view().transpose() : batch.inputs.view(), labels, batch.classes, learning_rate);
+            }
+            pipeline->release();
         }
 
         std::cout << "Epoch loss: " << epoch_loss / BATCH_PER_EPOCH << '\n';
+        std::cout << std::format("Step arena peak: {:.1f} KiB\n", step_arena_peak / 1024.0);
+        if (pipeline) {
+            std::cout << pipeline->stats() << '\n';
+            pipeline->reset_stats();
+        }
 
         if (validation.has_value()) {
             performance::metrics metrics = 
@@ -82,7 +341,12 @@ void NeuralNetwork::fit(
             std::cout << "Validation " << metrics << '\n';
             
             if (!best_model || metrics.accuracy > best_accuracy) {
-                best_model = std::make_unique<NeuralNetwork>(*this);
+                /* Snapshots after the first reuse the buffers of the previous one */
+                if (best_model) {
+                    *best_model = *this;
+                } else {
+                    best_model = std::make_unique<NeuralNetwork>(*this);
+                }
                 best_accuracy = metrics.accuracy;
                 patience = 0;
             } else if (validation.value().early_stop
@@ -93,6 +357,9 @@ void NeuralNetwork::fit(
         }
     }
 
+    /* Stops the workers, which may be gathering batches of epochs that early stopping cut */
+    pipeline.reset();
+
     if (config.best_model) {
         std::cout << "Restoring best model." << '\n';
         *this = *best_model;
@@ -103,47 +370,76 @@ void NeuralNetwork::fit(
     }
 }
 
-performance::metrics NeuralNetwork::evaluate(const Matrix& input, const Matrix& labels, loss::Type loss_type) const {
-    Matrix pred = predict(input);
-    const double loss = loss::compute(labels, pred, loss_type);
-    double correct = 0;
-    for (int col { 0 }; col < labels.cols(); ++col) {
-        int prediction = 0;
-        int label = 0;
-        for (int row { 1 }; row < labels.rows(); ++row) {
-            if (pred[row, col] > pred[prediction, col]) {
-                prediction = row;
-            }
-            if (labels[row, col] > labels[label, col]) {
-                label = row;
-            }
-        }
-        if (prediction == label) {
-            correct += 1.0;
-        }
-    }
-    return {loss, correct / labels.cols()};
+template <typename T, typename Master>
+performance::metrics NeuralNetwork<T, Master>::evaluate(const MatrixView<T>& input, const MatrixView<T>& labels, loss::Type loss_type) const {
+    const Matrix<T> pred = predict(input);
+    return performance::measure(pred.view(), labels, loss_type);
 }
 
+template <typename T, typename Master>
+performance::metrics NeuralNetwork<T, Master>::evaluate(const Dataset& dataset, loss::Type loss_type) const {
+    std::vector<int> order(dataset.samples());
+    std::iota(order.begin(), order.end(), 0);
+    Matrix<T> inputs { 1, dataset.features() };
+    Matrix<T> labels { dataset.classes(), 1 };
+
+    /* Batch metrics are means, so they are weighted by the size of their batch */
+    performance::metrics total;
+    for (int start { 0 }; start < dataset.samples(); start += EVALUATION_BATCH) {
+        const int end = std::min(start + EVALUATION_BATCH, dataset.samples());
+        dataset.samples_into(inputs, order, start, end);
+        dataset.labels_into(labels, order, start, end);
+        const performance::metrics batch = evaluate(inputs.view().transpose(), labels, loss_type);
+        total.loss += batch.loss * (end - start);
+        total.accuracy += batch.accuracy * (end - start);
+    }
+    total.loss /= dataset.samples();
+    total.accuracy /= dataset.samples();
+    return total;
+}
 
-Matrix NeuralNetwork::predict(const Matrix& input) const {
-    Matrix a = input;
-    for (auto& layer : layers) {
-        a = layer.predict(a);
+template <typename T, typename Master>
+Matrix<T> NeuralNetwork<T, Master>::predict(const MatrixView<T>& input) const {
+    /* Intermediate activations live in the arena; only the final output is copied out of it */
+    pool::ArenaScope scope { step_arena };
+    Matrix<T> a = Matrix<T>::scratch(1, 1);
+    Matrix<T> next = Matrix<T>::scratch(1, 1);
+    layers.front().predict_into(a, input);
+    for (size_t i { 1 }; i < layers.size(); ++i) {
+        layers[i].predict_into(next, a);
+        std::swap(a, next);
     }
-    return a;
+    return Matrix<T> { a.view() };
 }
 
-Matrix NeuralNetwork::random_cols(const Matrix& data, const std::vector<int>& idx, int start, int end) {
+template <typename T, typename Master>
+void NeuralNetwork<T, Master>::random_cols_into(Matrix<T>& out, const MatrixView<T>& data, const std::vector<int>& idx, int start, int end) {
     int rows = data.rows();
     int cols = end - start;
-    Matrix out(rows, cols);
+    out.resize(rows, cols);
 
-    for (int j { 0 }; j < cols; ++j) {
-        int src_col = idx[start + j];
-        for (int r { 0 }; r < rows; ++r)
-            out[r, j] = data[r, src_col];
-    }
-    return out;
+    parallel::for_each_chunk(static_cast<size_t>(rows), 8, [&](size_t first, size_t last) {
+        for (int r { static_cast<int>(first) }; r < static_cast<int>(last); ++r) {
+            for (int j { 0 }; j < cols; ++j) {
+                out[r, j] = data[r, idx[start + j]];
+            }
+        }
+    }, static_cast<size_t>(rows) * static_cast<size_t>(cols));
+}
+
+template <typename T, typename Master>
+void NeuralNetwork<T, Master>::random_samples_into(Matrix<T>& out, const MatrixView<T>& data, const std::vector<int>& idx, int start, int end) {
+    const int rows = end - start;
+    const std::size_t features = static_cast<std::size_t>(data.rows());
+    out.resize(rows, data.rows());
+
+    parallel::for_each_chunk(static_cast<size_t>(rows), 1, [&](size_t first, size_t last) {
+        for (int j { static_cast<int>(first) }; j < static_cast<int>(last); ++j) {
+            std::memcpy(&out[j, 0], &data[0, idx[start + j]], features * sizeof(T));
+        }
+    }, static_cast<size_t>(rows) * features);
 }
 
+template class NeuralNetwork<float>;
+template class NeuralNetwork<double>;
+template class NeuralNetwork<float, double>;
@@ -1,18 +1,26 @@
 #pragma once
 
 #include "Config.h"
+#include "Dataset.h"
 #include "Layer.h"
 #include "Loss.h"
 #include "Matrix.h"
+#include "Parameters.h"
 #include "Performance.h"
-#include "Regularization.h"
+#include "Pool.h"
+#include "SparseMatrix.h"
 #include <optional>
+#include <span>
 #include <vector>
 
 /**
  * @class NeuralNetwork
  * @brief Represents a neural network model.
+ * @tparam T Element type of the data and of the forward and backward passes.
+ * @tparam Master Element type of the weights updated by the optimizers (defaults to T).
+ * @see Parameters for how mixed precision (Master wider than T) is handled.
  */
+template <typename T, typename Master = T>
 class NeuralNetwork {
 public:
     /**
@@ -21,6 +29,30 @@ public:
      */
     NeuralNetwork(const config::Network& config);
 
+    /**
+     * @brief Copy constructor; the copy draws its layers from its own parameter buffers.
+     * @param other The network to copy.
+     */
+    NeuralNetwork(const NeuralNetwork& other);
+
+    /**
+     * @brief Copy assignment operator.
+     * @param other The network to copy.
+     * @return Reference to this network after assignment.
+     * @note When both networks have the same layers, the parameter buffers are copied in place.
+     */
+    NeuralNetwork& operator=(const NeuralNetwork& other);
+
+    /**
+     * @brief Move constructor.
+     */
+    NeuralNetwork(NeuralNetwork&&) noexcept = default;
+
+    /**
+     * @brief Move assignment operator.
+     */
+    NeuralNetwork& operator=(NeuralNetwork&&) noexcept = default;
+
     /**
      * @brief Trains the neural network using the provided input and label matrices.
      * @param input The input data matrix.
@@ -29,23 +61,64 @@ public:
      * @note This function performs a single training step and should be called iteratively.
      */
     void train(
-        const Matrix& input, 
-        const Matrix& label, 
+        const MatrixView<T>& input,
+        const MatrixView<T>& label,
+        double learning_rate
+    );
+
+    /**
+     * @brief Trains the neural network on a sparse input batch.
+     * @param input The sparse input data matrix.
+     * @param label The label data matrix.
+     * @param learning_rate The learning rate for the training process.
+     * @note The first layer multiplies the sparse input directly, in the forward pass and for its weight gradient.
+     */
+    void train(
+        const SparseMatrix<T>& input,
+        const MatrixView<T>& label,
         double learning_rate
     );
 
     /**
      * @brief Fits the model to the training data.
-     * @param input The input data matrix.
+     * @param input The input data matrix, one sample per column. A transposed view of sample-major data
+     * (see mnist::Layout) is gathered with one copy per sample and fed to the GEMM as a transposed view.
+     * @param label The label data matrix.
+     * @param config The training configuration.
+     * @param validation Optional validation configuration for improvement and early stopping.
+     */
+    void fit(
+        const MatrixView<T>& input,
+        const MatrixView<T>& label,
+        const config::Training& config, 
+        std::optional<config::Validation<T>> validation = std::nullopt
+    );
+
+    /**
+     * @brief Fits the model to sparse training data.
+     * @param input The sparse input data matrix, such as the one returned by mnist::load_sparse.
      * @param label The label data matrix.
      * @param config The training configuration.
      * @param validation Optional validation configuration for improvement and early stopping.
      */
     void fit(
-        const Matrix& input, 
-        const Matrix& label, 
+        const SparseMatrix<T>& input,
+        const MatrixView<T>& label,
         const config::Training& config, 
-        std::optional<config::Validation> validation = std::nullopt
+        std::optional<config::Validation<T>> validation = std::nullopt
+    );
+
+    /**
+     * @brief Fits the model to a dataset of uint8 samples.
+     * @param dataset The training samples, such as the one returned by mnist::load_dataset or mnist::map.
+     * @param config The training configuration.
+     * @param validation Optional validation configuration for improvement and early stopping.
+     * @note Every batch is converted from bytes when it is gathered; the fused loss reads the labels as class indices.
+     */
+    void fit(
+        const Dataset& dataset,
+        const config::Training& config,
+        std::optional<config::Validation<T>> validation = std::nullopt
     );
 
     /**
@@ -56,8 +129,20 @@ public:
      * @return A metrics object containing the loss and accuracy.
      */
     [[nodiscard]] performance::metrics evaluate(
-        const Matrix& input, 
-        const Matrix& labels,
+        const MatrixView<T>& input,
+        const MatrixView<T>& labels,
+        loss::Type loss_type
+    ) const;
+
+    /**
+     * @brief Evaluates the model's performance on a dataset of uint8 samples.
+     * @param dataset The samples to evaluate on.
+     * @param loss_type The type of loss function to use for evaluation.
+     * @return A metrics object containing the loss and accuracy, averaged over every sample.
+     * @note The samples are converted and predicted in batches, so the dataset is never materialized in floating point.
+     */
+    [[nodiscard]] performance::metrics evaluate(
+        const Dataset& dataset,
         loss::Type loss_type
     ) const;
 
@@ -66,9 +151,15 @@ public:
      * @param input The input data matrix.
      * @return The predicted output matrix.
      */
-    [[nodiscard]] Matrix predict(
-        const Matrix& input
+    [[nodiscard]] Matrix<T> predict(
+        const MatrixView<T>& input
     ) const;
+
+    /**
+     * @brief Returns the layers of the network, from input to output.
+     * @return The trained layers.
+     */
+    [[nodiscard]] const std::vector<Layer<T>>& get_layers() const noexcept { return layers; }
 private:
 
     /**
@@ -77,33 +168,79 @@ private:
     loss::Type loss;
 
     /**
-     * @brief Regularization settings for the neural network.
+     * @brief Flat buffers of the weights, gradients and optimizer state of every layer.
+     * @note Declared before layers, whose matrices are drawn from it.
      */
-    regularization::Settings regularization;
+    Parameters<T, Master> parameters;
 
     /**
-     * @brief Weight decay factor for regularization.
+     * @brief Layers of the neural network.
      */
-    double weight_decay;
+    std::vector<Layer<T>> layers;
 
     /**
-     * @brief Layers of the neural network.
+     * @brief Loss value for the current epoch.
      */
-    std::vector<Layer> layers;
+    double epoch_loss = 0.0;
 
     /**
-     * @brief Loss value for the current epoch.
+     * @brief Largest arena footprint of a single training step in the current epoch, in bytes.
      */
-    double epoch_loss;
+    std::size_t step_arena_peak = 0;
+
+    /**
+     * @brief Class indices of the current batch, read by the fused softmax cross-entropy loss.
+     */
+    std::vector<int> batch_classes;
 
     /**
      * @brief Random batch matrix generator from the input data with given order and range.
+     * @param out Destination, resized to (data.rows() x (end - start)) only if its shape differs.
      * @param data The input data matrix.
      * @param idx The order of indices to select columns from the data.
      * @param start The starting index for the range of columns to select.
      * @param end The ending index for the range of columns to select.
-     * @return A new matrix containing the selected columns from the input data.
      * @note This function is used to create batches of data for training.
      */
-    static Matrix random_cols(const Matrix& data, const std::vector<int>& idx, int start, int end);
+    static void random_cols_into(Matrix<T>& out, const MatrixView<T>& data, const std::vector<int>& idx, int start, int end);
+
+    /**
+     * @brief Random batch generator from sample-major data, whose columns are contiguous, with given order and range.
+     * @param out Destination, resized to ((end - start) x data.rows()) only if its shape differs; one sample per row.
+     * @param data The input data, a transposed view of a matrix with one sample per row.
+     * @param idx The order of indices to select columns from the data.
+     * @param start The starting index for the range of columns to select.
+     * @param end The ending index for the range of columns to select.
+     * @note Every sample is gathered with one memcpy; out is passed on as its transposed view.
+     */
+    static void random_samples_into(Matrix<T>& out, const MatrixView<T>& data, const std::vector<int>& idx, int start, int end);
+
+    /**
+     * @brief Checks whether another network has the same layers, so its parameter buffers can be copied in place.
+     */
+    [[nodiscard]] bool same_layers(const NeuralNetwork& other) const noexcept;
+
+    /**
+     * @brief Checks whether the output layer and loss can use the fused softmax cross-entropy kernel.
+     */
+    [[nodiscard]] bool fused_loss() const noexcept;
+
+    /**
+     * @brief Runs one training step on a dense or sparse input batch.
+     * @param classes Class indices of the batch for the fused loss; derived from label when empty.
+     */
+    template <typename Input>
+    void train_step(const Input& input, const MatrixView<T>& label, std::span<const int> classes, double learning_rate);
+
+    /**
+     * @brief Runs the epochs of fit on dense, sparse or uint8 training data.
+     * @param label The one-hot labels; unused for a Dataset, which holds its own.
+     */
+    template <typename Input>
+    void fit_epochs(
+        const Input& input,
+        const MatrixView<T>& label,
+        const config::Training& config,
+        std::optional<config::Validation<T>> validation
+    );
 };
@@ -1,55 +1,140 @@
 #include "Optimizer.h"
+#include "ThreadPool.h"
 #include <cmath>
 #include <stdexcept>
 
-std::shared_ptr<optimizer::Base> optimizer::create(
-    int rows, int cols, 
+template <typename T>
+optimizer::Engine<T> optimizer::create(
+    std::size_t size,
     const optimizer::Settings& optimizer
 ) {
     switch (optimizer.type) {
         case Type::SGD:
-            return std::make_shared<optimizer::SGD>();
+            return optimizer::SGD<T> {};
         case Type::Momentum:
-            return std::make_shared<optimizer::Momentum>(rows, cols, optimizer.beta1);
+            return optimizer::Momentum<T> {size, optimizer.beta1};
         case Type::RMSProp:
-            return std::make_shared<optimizer::RMSProp>(rows, cols, optimizer.beta2, optimizer.epsilon);
+            return optimizer::RMSProp<T> {size, optimizer.beta2, optimizer.epsilon};
         case Type::Adam:
-            return std::make_shared<optimizer::Adam>(rows, cols, optimizer.beta1, optimizer.beta2, optimizer.epsilon);
+            return optimizer::Adam<T> {size, optimizer.beta1, optimizer.beta2, optimizer.epsilon};
         default:
             throw std::invalid_argument("unknown optimizer type");
     }
 }
 
-void optimizer::SGD::update(Matrix& param, const Matrix& grad, double lr) {
-    param -= lr * grad;
-}
+/**
+ * @brief Penalty of an update, converted to the element type once per call.
+ * @details Every update applies it to the parameter in the register it is loaded into,
+ * so regularization and weight decay cost no extra pass over the weights.
+ */
+template <typename T>
+struct Folded {
+    T l1;       ///< L1 regularization coefficient
+    T l2;       ///< L2 regularization coefficient
+    T shrink;   ///< Learning rate times weight decay
+
+    Folded(const optimizer::Penalty& penalty, double lr)
+        : l1 {static_cast<T>(penalty.l1)}
+        , l2 {static_cast<T>(penalty.l2)}
+        , shrink {static_cast<T>(lr * penalty.weight_decay)}
+    {}
+
+    /**
+     * @brief Adds the regularization term of parameter p to its gradient g.
+     */
+    [[nodiscard]] T gradient(T p, T g) const noexcept {
+        const T sign = static_cast<T>((T { 0 } < p) - (p < T { 0 }));
+        return g + l1 * sign + l2 * p;
+    }
+
+    /**
+     * @brief Returns the decayed parameter p.
+     */
+    [[nodiscard]] T decay(T p) const noexcept {
+        return p - shrink * p;
+    }
+};
 
-void optimizer::Momentum::update(Matrix& param, const Matrix& grad, double lr) {
-    velocity = momentum * velocity - lr * grad;
-    param += velocity;
+template <typename T>
+void optimizer::SGD<T>::update(std::span<T> param, std::span<const T> grad, double lr, const optimizer::Penalty& penalty) {
+    const T rate = static_cast<T>(lr);
+    const Folded<T> folded { penalty, lr };
+    parallel::for_each_chunk(param.size(), parallel::GRAIN, [&](size_t first, size_t last) {
+        for (size_t i { first }; i < last; ++i) {
+            const T p = param[i];
+            param[i] = folded.decay(p) - rate * folded.gradient(p, grad[i]);
+        }
+    });
 }
 
-void optimizer::RMSProp::update(Matrix& param, const Matrix& grad, double lr) {
-    cache = decay * cache + (1 - decay) * (grad.hadamard(grad));
+template <typename T>
+void optimizer::Momentum<T>::update(std::span<T> param, std::span<const T> grad, double lr, const optimizer::Penalty& penalty) {
+    const T rate = static_cast<T>(lr);
+    const Folded<T> folded { penalty, lr };
+    const T beta = static_cast<T>(momentum);
+    parallel::for_each_chunk(param.size(), parallel::GRAIN, [&](size_t first, size_t last) {
+        for (size_t i { first }; i < last; ++i) {
+            const T p = param[i];
+            const T vel = beta * velocity[i] - rate * folded.gradient(p, grad[i]);
+            velocity[i] = vel;
+            param[i] = folded.decay(p) + vel;
+        }
+    });
+}
 
-    const Matrix denom = cache.apply([this](double x) {return std::sqrt(x) + this->epsilon;});
-    
-    param -= lr * (grad.hadamard_div(denom));
+template <typename T>
+void optimizer::RMSProp<T>::update(std::span<T> param, std::span<const T> grad, double lr, const optimizer::Penalty& penalty) {
+    const T rate = static_cast<T>(lr);
+    const Folded<T> folded { penalty, lr };
+    const T keep = static_cast<T>(decay);
+    const T blend = static_cast<T>(1 - decay);
+    const T eps = static_cast<T>(epsilon);
+    parallel::for_each_chunk(param.size(), parallel::GRAIN, [&](size_t first, size_t last) {
+        for (size_t i { first }; i < last; ++i) {
+            const T p = param[i];
+            const T g = folded.gradient(p, grad[i]);
+            const T c = keep * cache[i] + blend * (g * g);
+            cache[i] = c;
+            param[i] = folded.decay(p) - rate * g / (std::sqrt(c) + eps);
+        }
+    });
 }
 
-void optimizer::Adam::update(Matrix& param, const Matrix& grad, double lr) {
+template <typename T>
+void optimizer::Adam<T>::update(std::span<T> param, std::span<const T> grad, double lr, const optimizer::Penalty& penalty) {
     ++t;
     cache_p1 *= beta1;
     cache_p2 *= beta2;
 
-    m = beta1 * m + (1 - beta1) * grad;
-    v = beta2 * v + (1 - beta2) * (grad.hadamard(grad));
-
-    const Matrix m_ = m / (1 - cache_p1);
-    const Matrix v_ = v / (1 - cache_p2);
-
-    const Matrix denom = v_.apply([this](double x) {return std::sqrt(x) + this->epsilon;}); 
-    param -= lr * (m_.hadamard_div(denom));
+    /* Bias corrections are folded into the sqrt and the step size instead of building corrected copies */
+    const T inv_correction = static_cast<T>(1 / (1 - cache_p2));
+    const T step = static_cast<T>(lr / (1 - cache_p1));
+    const Folded<T> folded { penalty, lr };
+    const T b1 = static_cast<T>(beta1);
+    const T b2 = static_cast<T>(beta2);
+    const T blend1 = static_cast<T>(1 - beta1);
+    const T blend2 = static_cast<T>(1 - beta2);
+    const T eps = static_cast<T>(epsilon);
+    parallel::for_each_chunk(param.size(), parallel::GRAIN, [&](size_t first, size_t last) {
+        for (size_t i { first }; i < last; ++i) {
+            const T p = param[i];
+            const T g = folded.gradient(p, grad[i]);
+            const T mi = b1 * m[i] + blend1 * g;
+            const T vi = b2 * v[i] + blend2 * (g * g);
+            m[i] = mi;
+            v[i] = vi;
+            param[i] = folded.decay(p) - step * mi / (std::sqrt(vi * inv_correction) + eps);
+        }
+    });
 }
 
-
+template optimizer::Engine<float> optimizer::create(std::size_t, const optimizer::Settings&);
+template optimizer::Engine<double> optimizer::create(std::size_t, const optimizer::Settings&);
+template class optimizer::SGD<float>;
+template class optimizer::SGD<double>;
+template class optimizer::Momentum<float>;
+template class optimizer::Momentum<double>;
+template class optimizer::RMSProp<float>;
+template class optimizer::RMSProp<double>;
+template class optimizer::Adam<float>;
+template class optimizer::Adam<double>;
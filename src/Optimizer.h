@@ -1,7 +1,10 @@
 #pragma once
 
-#include "Matrix.h"
-#include <memory>
+#include "Pool.h"
+#include <cstddef>
+#include <span>
+#include <variant>
+#include <vector>
 
 /**
  * @namespace optimizer
@@ -32,67 +35,70 @@ namespace optimizer {
     };
 
     /**
-     * @class Base
-     * @brief Base class for all optimizers.
+     * @struct Penalty
+     * @brief Regularization and weight decay the optimizers apply while updating a parameter.
+     * @details Both are computed from the parameter before the step: the gradient becomes
+     * grad + l1 * sign(w) + l2 * w and the parameter is decayed by lr * weight_decay * w.
      */
-    class Base {
-    public:
-        /**
-         * @brief Default destructor.
-         */
-        virtual ~Base() = default;
-
-        /**
-         * @brief Updates the parameters using the optimizer's algorithm.
-         * @param m The matrix containing the parameters to be updated.
-         * @param grad The gradient of the loss with respect to the parameters.
-         * @param lr The learning rate for the update.
-         */
-        virtual void update(Matrix& m, const Matrix& grad, double lr) = 0;
+    struct Penalty {
+        double l1 = 0.0;            ///< L1 regularization coefficient (default = 0 = none)
+        double l2 = 0.0;            ///< L2 regularization coefficient (default = 0 = none)
+        double weight_decay = 0.0;  ///< Decoupled weight decay factor (default = 0 = none)
     };
 
+    /**
+     * @brief Flat buffer holding the moments of an optimizer.
+     */
+    template <typename T>
+    using Moments = std::vector<T, pool::Allocator<T>>;
+
     /**
      * @class SGD
      * @brief Implements the Stochastic Gradient Descent optimization algorithm.
+     * @tparam T Element type of the parameters.
      */
-    class SGD final : public Base {
+    template <typename T>
+    class SGD {
     public:
         /**
-         * @brief Updates the parameters using the SGD algorithm.
-         * @param param The matrix containing the parameters to be updated.
+         * @brief Applies the penalty and the SGD update in a single pass.
+         * @param param The parameters to be updated.
          * @param grad The gradient of the loss with respect to the parameters.
          * @param lr The learning rate for the update.
+         * @param penalty Regularization and weight decay applied in the same pass.
          */
-        void update(Matrix& param, const Matrix& grad, double lr) override;
+        void update(std::span<T> param, std::span<const T> grad, double lr, const Penalty& penalty);
     };
 
     /**
      * @class Momentum
      * @brief Implements the Momentum optimization algorithm.
+     * @tparam T Element type of the parameters.
      */
-    class Momentum final : public Base {
+    template <typename T>
+    class Momentum {
     public:
         /**
-         * @brief Constructs a Momentum optimizer with the specified dimensions and momentum factor.
-         * @param rows Number of rows in the parameter matrix.
-         * @param cols Number of columns in the parameter matrix.
+         * @brief Constructs a Momentum optimizer with the specified size and momentum factor.
+         * @param size Number of parameters.
          * @param momentum Momentum factor.
          */
-        Momentum(int rows, int cols, double momentum)
-            : velocity(rows, cols), momentum {momentum} {}
+        Momentum(std::size_t size, double momentum)
+            : velocity(size), momentum {momentum} {}
 
         /**
-         * @brief Updates the parameters using the Momentum algorithm.
-         * @param param The matrix containing the parameters to be updated.
+         * @brief Applies the penalty and the Momentum update in a single pass.
+         * @param param The parameters to be updated.
          * @param grad The gradient of the loss with respect to the parameters.
          * @param lr The learning rate for the update.
+         * @param penalty Regularization and weight decay applied in the same pass.
          */
-        void update(Matrix& param, const Matrix& grad, double lr) override;
+        void update(std::span<T> param, std::span<const T> grad, double lr, const Penalty& penalty);
     private:
         /**
-         * @brief The velocity matrix used in the Momentum algorithm.
+         * @brief The velocity used in the Momentum algorithm.
          */
-        Matrix velocity;
+        Moments<T> velocity;
 
         /**
          * @brief The momentum factor used in the Momentum algorithm.
@@ -103,31 +109,33 @@ namespace optimizer {
     /**
      * @class RMSProp
      * @brief Implements the RMSProp optimization algorithm.
+     * @tparam T Element type of the parameters.
      */
-    class RMSProp final : public Base {
+    template <typename T>
+    class RMSProp {
     public:
         /**
-         * @brief Constructs an RMSProp optimizer with the specified dimensions, decay factor, and epsilon.
-         * @param rows Number of rows in the parameter matrix.
-         * @param cols Number of columns in the parameter matrix.
+         * @brief Constructs an RMSProp optimizer with the specified size, decay factor, and epsilon.
+         * @param size Number of parameters.
          * @param decay Decay factor for the moving average of squared gradients.
          * @param epsilon Small constant to avoid division by zero.
          */
-        RMSProp(int rows, int cols, double decay, double epsilon)
-            : cache(rows, cols), decay {decay}, epsilon {epsilon} {}
+        RMSProp(std::size_t size, double decay, double epsilon)
+            : cache(size), decay {decay}, epsilon {epsilon} {}
         
         /**
-         * @brief Updates the parameters using the RMSProp algorithm.
-         * @param param The matrix containing the parameters to be updated.
+         * @brief Applies the penalty and the RMSProp update in a single pass.
+         * @param param The parameters to be updated.
          * @param grad The gradient of the loss with respect to the parameters.
          * @param lr The learning rate for the update.  
+         * @param penalty Regularization and weight decay applied in the same pass.
          */
-        void update(Matrix& param, const Matrix& grad, double lr) override;
+        void update(std::span<T> param, std::span<const T> grad, double lr, const Penalty& penalty);
     private:
         /**
-         * @brief The cache matrix used in the RMSProp algorithm to store the moving average of squared gradients.
+         * @brief The moving average of squared gradients used in the RMSProp algorithm.
          */
-        Matrix cache;
+        Moments<T> cache;
         
         /**
          * @brief The decay factor for the moving average of squared gradients.
@@ -143,39 +151,41 @@ namespace optimizer {
     /**
      * @class Adam
      * @brief Implements the Adam optimization algorithm.
+     * @tparam T Element type of the parameters.
      */
-    class Adam final : public Base {
+    template <typename T>
+    class Adam {
     public:
         /**
-         * @brief Constructs an Adam optimizer with the specified dimensions, beta1, beta2, and epsilon.
-         * @param rows Number of rows in the parameter matrix.
-         * @param cols Number of columns in the parameter matrix.
+         * @brief Constructs an Adam optimizer with the specified size, beta1, beta2, and epsilon.
+         * @param size Number of parameters.
          * @param beta1 Exponential decay rate for the first moment estimates.
          * @param beta2 Exponential decay rate for the second moment estimates.
          * @param epsilon Small constant to avoid division by zero.
          */
-        Adam(int rows, int cols, double beta1, double beta2, double epsilon)
-            : m(rows, cols), v(rows, cols)
+        Adam(std::size_t size, double beta1, double beta2, double epsilon)
+            : m(size), v(size)
             , beta1 {beta1}, beta2 {beta2}, epsilon {epsilon}
         {}
 
         /**
-         * @brief Updates the parameters using the Adam algorithm.
-         * @param param The matrix containing the parameters to be updated.
+         * @brief Applies the penalty and the Adam update in a single pass.
+         * @param param The parameters to be updated.
          * @param grad The gradient of the loss with respect to the parameters.
          * @param lr The learning rate for the update.
+         * @param penalty Regularization and weight decay applied in the same pass.
          */
-        void update(Matrix& param, const Matrix& grad, double lr) override;
+        void update(std::span<T> param, std::span<const T> grad, double lr, const Penalty& penalty);
     private:
         /**
-         * @brief The first moment estimates matrix used in the Adam algorithm.
+         * @brief The first moment estimates used in the Adam algorithm.
          */
-        Matrix m;
+        Moments<T> m;
 
         /**
-         * @brief The second moment estimates matrix used in the Adam algorithm.
+         * @brief The second moment estimates used in the Adam algorithm.
          */
-        Matrix v;
+        Moments<T> v;
         
         /**
          * @brief Exponential decay rate for the first moment estimates.
@@ -208,16 +218,38 @@ namespace optimizer {
         int t = 0;
     };
 
+    /**
+     * @brief Any of the optimizers, chosen at runtime from the settings.
+     * @details The variant is visited once per update, which then runs the element-wise loop of
+     * the held optimizer over the whole buffer. Copying it copies the moments.
+     */
+    template <typename T>
+    using Engine = std::variant<SGD<T>, Momentum<T>, RMSProp<T>, Adam<T>>;
+
     /**
      * @brief Creates an optimizer based on the specified settings.
-     * @param rows Number of rows in the parameter matrix.
-     * @param cols Number of columns in the parameter matrix.
+     * @param size Number of parameters it updates.
      * @param optimizer Settings for the optimizer to create.
-     * @return A shared pointer to the created optimizer.
+     * @return The created optimizer, with zero-filled moments.
      * @throws std::invalid_argument if the optimizer type is unknown.
      */
-    [[nodiscard]] std::shared_ptr<optimizer::Base> create(
-        int rows, int cols, 
+    template <typename T>
+    [[nodiscard]] Engine<T> create(
+        std::size_t size, 
         const optimizer::Settings& optimizer
     );
+
+    /**
+     * @brief Applies the penalty and the update of the held optimizer in a single pass over the parameters.
+     * @param engine The optimizer to run.
+     * @param param The parameters to be updated.
+     * @param grad The gradient of the loss with respect to the parameters.
+     * @param lr The learning rate for the update.
+     * @param penalty Regularization and weight decay applied in the same pass (default = none).
+     * @note param and grad must have the size the optimizer was created for.
+     */
+    template <typename T>
+    void update(Engine<T>& engine, std::span<T> param, std::span<const T> grad, double lr, const Penalty& penalty = {}) {
+        std::visit([&](auto& optimizer) { optimizer.update(param, grad, lr, penalty); }, engine);
+    }
 }
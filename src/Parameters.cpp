@@ -0,0 +1,160 @@
+#include "Parameters.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+/**
+ * @brief Returns the size an arena hands out for a block of count elements of type T.
+ */
+template <typename T>
+[[nodiscard]] static std::size_t drawn_bytes(std::size_t count) noexcept {
+    return (count * sizeof(T) + pool::ALIGNMENT - 1) & ~(pool::ALIGNMENT - 1);
+}
+
+/**
+ * @brief Copies a flat buffer into another of the same size, converting the elements.
+ */
+template <typename To, typename From>
+static void convert_into(std::span<To> out, std::span<const From> in) {
+    parallel::for_each_chunk(in.size(), parallel::GRAIN, [&](size_t first, size_t last) {
+        for (size_t i { first }; i < last; ++i) {
+            out[i] = static_cast<To>(in[i]);
+        }
+    });
+}
+
+template <typename T, typename Master>
+Parameters<T, Master>::Buffer::Buffer(std::size_t bytes)
+    : arena {std::make_unique<pool::Arena>()}
+    , bytes {bytes}
+{
+    arena->reserve(bytes);
+    std::memset(arena->data(), 0, bytes);
+}
+
+template <typename T, typename Master>
+Parameters<T, Master>::Parameters(const config::Network& config)
+    : Parameters(
+        [&config] {
+            std::size_t bytes = 0;
+            int input = config.input_size;
+            for (const auto& layer : config.layers) {
+                bytes += drawn_bytes<T>(static_cast<std::size_t>(layer.units) * static_cast<std::size_t>(input));
+                input = layer.units;
+            }
+            return bytes;
+        }(),
+        [&config] {
+            std::size_t bytes = 0;
+            for (const auto& layer : config.layers) {
+                bytes += drawn_bytes<T>(static_cast<std::size_t>(layer.units));
+            }
+            return bytes;
+        }(),
+        config.optimizer,
+        [&config] {
+            const regularization::Coefficients terms = regularization::coefficients(config.regularization);
+            return optimizer::Penalty { terms.l1, terms.l2, config.weight_decay > 0.0 ? config.weight_decay : 0.0 };
+        }()
+    )
+{}
+
+template <typename T, typename Master>
+Parameters<T, Master>::Parameters(
+    std::size_t weight_bytes, std::size_t bias_bytes,
+    const optimizer::Settings& optimizer,
+    const optimizer::Penalty& penalty
+)
+    : weights {weight_bytes}
+    , biases {bias_bytes}
+    , weight_gradients {weight_bytes}
+    , bias_gradients {bias_bytes}
+    , optimizer_settings {optimizer}
+    , penalty {penalty}
+    , optimizer_weights {optimizer::create<Master>(weight_bytes / sizeof(T), optimizer)}
+    , optimizer_biases {optimizer::create<Master>(bias_bytes / sizeof(T), optimizer)}
+{
+    if constexpr (mixed) {
+        const std::size_t weight_count = weight_bytes / sizeof(T);
+        const std::size_t bias_count = bias_bytes / sizeof(T);
+        master.weights.resize(weight_count);
+        master.biases.resize(bias_count);
+        master.weight_gradients.resize(weight_count);
+        master.bias_gradients.resize(bias_count);
+    }
+}
+
+template <typename T, typename Master>
+Parameters<T, Master> Parameters<T, Master>::layout() const {
+    return Parameters { weights.size(), biases.size(), optimizer_settings, penalty };
+}
+
+template <typename T, typename Master>
+parameters::Slots<T> Parameters<T, Master>::slots() const noexcept {
+    return {weights.allocator(), biases.allocator(), weight_gradients.allocator(), bias_gradients.allocator()};
+}
+
+template <typename T, typename Master>
+void Parameters<T, Master>::bind() {
+    if (!weights.drawn() || !biases.drawn() || !weight_gradients.drawn() || !bias_gradients.drawn()) {
+        throw std::logic_error("layers do not match the layout of the parameter buffers");
+    }
+    if constexpr (mixed) {
+        convert_into<Master, T>(master.weights, weights.span());
+        convert_into<Master, T>(master.biases, biases.span());
+    }
+}
+
+template <typename T, typename Master>
+void Parameters<T, Master>::update(double learning_rate) {
+    if constexpr (mixed) {
+        convert_into<Master, T>(master.weight_gradients, weight_gradients.span());
+        convert_into<Master, T>(master.bias_gradients, bias_gradients.span());
+        update_flat(master.weights, master.biases, master.weight_gradients, master.bias_gradients, learning_rate);
+        convert_into<T, Master>(weights.span(), master.weights);
+        convert_into<T, Master>(biases.span(), master.biases);
+    } else {
+        update_flat(weights.span(), biases.span(), weight_gradients.span(), bias_gradients.span(), learning_rate);
+    }
+}
+
+template <typename T, typename Master>
+void Parameters<T, Master>::update_flat(
+    std::span<Master> weight_values, std::span<Master> bias_values,
+    std::span<const Master> weight_grad, std::span<const Master> bias_grad,
+    double learning_rate
+) {
+    optimizer::update<Master>(optimizer_weights, weight_values, weight_grad, learning_rate, penalty);
+    optimizer::update<Master>(optimizer_biases, bias_values, bias_grad, learning_rate);
+}
+
+template <typename T, typename Master>
+void Parameters<T, Master>::assign(const Parameters& other) {
+    if (this == &other) {
+        return;
+    }
+    if (!same_layout(other)) {
+        throw std::invalid_argument("unmatched parameter buffer layouts");
+    }
+    std::ranges::copy(other.weights.span(), weights.span().begin());
+    std::ranges::copy(other.biases.span(), biases.span().begin());
+    std::ranges::copy(other.weight_gradients.span(), weight_gradients.span().begin());
+    std::ranges::copy(other.bias_gradients.span(), bias_gradients.span().begin());
+    if constexpr (mixed) {
+        master = other.master;
+    }
+    optimizer_settings = other.optimizer_settings;
+    penalty = other.penalty;
+    optimizer_weights = other.optimizer_weights;
+    optimizer_biases = other.optimizer_biases;
+}
+
+template <typename T, typename Master>
+bool Parameters<T, Master>::same_layout(const Parameters& other) const noexcept {
+    return weights.size() == other.weights.size() && biases.size() == other.biases.size();
+}
+
+template class Parameters<float>;
+template class Parameters<double>;
+template class Parameters<float, double>;
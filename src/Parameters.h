@@ -0,0 +1,244 @@
+#pragma once
+
+#include "Config.h"
+#include "Optimizer.h"
+#include "Pool.h"
+#include "Regularization.h"
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <variant>
+#include <vector>
+
+/**
+ * @namespace parameters
+ * @brief Contains the types the layers use to draw their storage from a Parameters object.
+ */
+namespace parameters {
+
+    /**
+     * @struct Slots
+     * @brief Allocators of the flat buffers, one per kind of parameter or gradient.
+     * @details Every layer draws one matrix of each kind, in layer order, so the matrices of
+     * consecutive layers sit next to each other in every buffer.
+     * @tparam T Element type of the forward and backward passes.
+     */
+    template <typename T>
+    struct Slots {
+        pool::Allocator<T> weights;             ///< Draws the weight matrices
+        pool::Allocator<T> biases;              ///< Draws the bias vectors
+        pool::Allocator<T> weight_gradients;    ///< Draws the weight gradients
+        pool::Allocator<T> bias_gradients;      ///< Draws the bias gradients
+    };
+}
+
+/**
+ * @class Parameters
+ * @brief Weights, biases, their gradients and the optimizer state of a whole network, in flat buffers.
+ * @details The layers hold their weights and gradients as matrices drawn from the buffers, so the update,
+ * the regularization and the copies of a snapshot each run as one linear pass per buffer instead of
+ * a pass per layer. Every matrix starts on a pool::ALIGNMENT boundary; the padding between two matrices
+ * is zero-filled and stays zero through the updates.
+ *
+ * When Master differs from T (mixed precision), flat Master copies of the weights and biases are the
+ * source of truth: the gradients are widened to Master before the optimizer step and the updated
+ * weights are rounded back to T for the next pass.
+ * @tparam T Element type of the forward and backward passes.
+ * @tparam Master Element type of the weights updated by the optimizers (defaults to T).
+ */
+template <typename T, typename Master = T>
+class Parameters {
+public:
+    /**
+     * @brief Reserves zero-filled buffers for the layers of a network configuration.
+     * @param config The configuration of the network, for the layer sizes and the update settings.
+     * @throws std::invalid_argument if the optimizer type is unknown.
+     */
+    explicit Parameters(const config::Network& config);
+
+    Parameters(const Parameters&) = delete;
+    Parameters& operator=(const Parameters&) = delete;
+
+    /**
+     * @brief Move constructor; the layers keep drawing from the moved buffers.
+     */
+    Parameters(Parameters&&) noexcept = default;
+
+    /**
+     * @brief Move assignment operator; the layers keep drawing from the moved buffers.
+     */
+    Parameters& operator=(Parameters&&) noexcept = default;
+
+    /**
+     * @brief Reserves zero-filled buffers with the same layout and settings as this object.
+     * @return New parameters, to be drawn by copies of the layers and filled with assign.
+     */
+    [[nodiscard]] Parameters layout() const;
+
+    /**
+     * @brief Returns the allocators the layers draw their matrices from.
+     * @return Allocators of the flat buffers.
+     */
+    [[nodiscard]] parameters::Slots<T> slots() const noexcept;
+
+    /**
+     * @brief Completes the buffers once every layer has drawn and initialized its matrices.
+     * @throws std::logic_error if the layers did not draw exactly the matrices the buffers were reserved for.
+     * @note In mixed precision, copies the initialized weights into the master copy.
+     */
+    void bind();
+
+    /**
+     * @brief Applies the optimizers, with regularization and weight decay folded into the weight update, to every parameter.
+     * @param learning_rate Learning rate for the update.
+     */
+    void update(double learning_rate);
+
+    /**
+     * @brief Copies the parameters, gradients and optimizer state of another object with the same layout.
+     * @param other The parameters to copy.
+     * @throws std::invalid_argument if the layouts differ.
+     */
+    void assign(const Parameters& other);
+
+    /**
+     * @brief Checks whether another object has buffers of the same sizes.
+     * @param other The parameters to compare with.
+     * @return True if the buffers of both can be copied into each other.
+     */
+    [[nodiscard]] bool same_layout(const Parameters& other) const noexcept;
+private:
+    /**
+     * @brief Whether the weights are kept and updated in a wider type than the passes run in.
+     */
+    static constexpr bool mixed = !std::same_as<T, Master>;
+
+    /**
+     * @brief Flat buffer of Master elements.
+     */
+    using Flat = std::vector<Master, pool::Allocator<Master>>;
+
+    /**
+     * @class Buffer
+     * @brief Zero-filled block of memory the layers draw matrices from, one after the other.
+     */
+    class Buffer {
+    public:
+        /**
+         * @brief Reserves a zero-filled block.
+         * @param bytes Size of the block, the sum of the matrices drawn from it rounded up to pool::ALIGNMENT each.
+         */
+        explicit Buffer(std::size_t bytes);
+
+        /**
+         * @brief Returns the allocator drawing matrices from the block.
+         * @return Allocator of the block.
+         */
+        [[nodiscard]] pool::Allocator<T> allocator() const noexcept { return pool::Allocator<T> { arena.get() }; }
+
+        /**
+         * @brief Returns the whole block, padding included.
+         * @return Elements of the block.
+         */
+        [[nodiscard]] std::span<T> span() const noexcept {
+            return {reinterpret_cast<T*>(arena->data()), bytes / sizeof(T)};
+        }
+
+        /**
+         * @brief Checks whether the matrices drawn so far fill the block exactly.
+         * @return True if the block is fully drawn.
+         */
+        [[nodiscard]] bool drawn() const noexcept { return arena->used() == bytes; }
+
+        /**
+         * @brief Returns the size of the block.
+         * @return Size in bytes.
+         */
+        [[nodiscard]] std::size_t size() const noexcept { return bytes; }
+    private:
+        /**
+         * @brief Arena serving the block; held by pointer so the layers' allocators survive a move.
+         */
+        std::unique_ptr<pool::Arena> arena;
+
+        /**
+         * @brief Size of the block in bytes.
+         */
+        std::size_t bytes;
+    };
+
+    /**
+     * @struct MasterCopy
+     * @brief Master precision weights and gradients of a mixed precision network.
+     */
+    struct MasterCopy {
+        Flat weights;           ///< Master weights, the source of truth for the compute weights
+        Flat biases;            ///< Master biases, the source of truth for the compute biases
+        Flat weight_gradients;  ///< Weight gradients widened to Master
+        Flat bias_gradients;    ///< Bias gradients widened to Master
+    };
+
+    /**
+     * @brief Constructs buffers of the given sizes.
+     */
+    Parameters(
+        std::size_t weight_bytes, std::size_t bias_bytes,
+        const optimizer::Settings& optimizer,
+        const optimizer::Penalty& penalty
+    );
+
+    /**
+     * @brief Weights of every layer.
+     */
+    Buffer weights;
+
+    /**
+     * @brief Biases of every layer.
+     */
+    Buffer biases;
+
+    /**
+     * @brief Weight gradients of every layer.
+     */
+    Buffer weight_gradients;
+
+    /**
+     * @brief Bias gradients of every layer.
+     */
+    Buffer bias_gradients;
+
+    /**
+     * @brief Master copy of the parameters, only present in mixed precision networks.
+     */
+    [[no_unique_address]] std::conditional_t<mixed, MasterCopy, std::monostate> master;
+
+    /**
+     * @brief Optimizer settings, kept to build buffers of the same layout.
+     */
+    optimizer::Settings optimizer_settings;
+
+    /**
+     * @brief Regularization and weight decay applied to the weights by their optimizer.
+     */
+    optimizer::Penalty penalty;
+
+    /**
+     * @brief Optimizer for every weight.
+     */
+    optimizer::Engine<Master> optimizer_weights;
+
+    /**
+     * @brief Optimizer for every bias.
+     */
+    optimizer::Engine<Master> optimizer_biases;
+
+    /**
+     * @brief Applies the optimizers to flat weights and biases.
+     */
+    void update_flat(
+        std::span<Master> weight_values, std::span<Master> bias_values,
+        std::span<const Master> weight_grad, std::span<const Master> bias_grad,
+        double learning_rate
+    );
+};
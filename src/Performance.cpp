@@ -1,7 +1,65 @@
 #include "Performance.h"
+#include "ThreadPool.h"
+#include <atomic>
 #include <format>
+#include <stdexcept>
+
+/**
+ * @brief Returns the row of the largest element of a column (the predicted class).
+ */
+template <typename T>
+[[nodiscard]] static int argmax(const MatrixView<T>& matrix, int col) noexcept {
+    int best = 0;
+    for (int row { 1 }; row < matrix.rows(); ++row) {
+        if (matrix[row, col] > matrix[best, col]) {
+            best = row;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Counts, in parallel, the columns whose largest elements are in the same row in both matrices.
+ */
+template <typename T>
+[[nodiscard]] static int matching_columns(const MatrixView<T>& lhs, const MatrixView<T>& rhs) {
+    if (lhs.rows() != rhs.rows() || lhs.cols() != rhs.cols()) {
+        throw std::invalid_argument(std::format(
+            "mismatched matrix dimensions ({}x{}) must be ({}x{})",
+            rhs.rows(), rhs.cols(), lhs.rows(), lhs.cols()
+        ));
+    }
+    std::atomic<int> matches = 0;
+    parallel::for_each_chunk(static_cast<size_t>(lhs.cols()), 256, [&](size_t first, size_t last) {
+        int hits = 0;
+        for (int col { static_cast<int>(first) }; col < static_cast<int>(last); ++col) {
+            if (argmax(lhs, col) == argmax(rhs, col)) {
+                ++hits;
+            }
+        }
+        matches += hits;
+    }, static_cast<size_t>(lhs.rows()) * static_cast<size_t>(lhs.cols()));
+    return matches;
+}
+
+template <typename T>
+performance::metrics performance::measure(const MatrixView<T>& predictions, const MatrixView<T>& labels, loss::Type loss_type) {
+    const double loss = loss::compute(labels, predictions, loss_type);
+    const int correct = matching_columns(predictions, labels);
+    return {loss, static_cast<double>(correct) / labels.cols()};
+}
+
+template <typename T>
+double performance::agreement(const MatrixView<T>& lhs, const MatrixView<T>& rhs) {
+    return static_cast<double>(matching_columns(lhs, rhs)) / lhs.cols();
+}
 
 std::ostream& operator<<(std::ostream& out, const performance::metrics& metrics) {
     out << std::format("Loss: {} | Accuracy: {}", metrics.loss, metrics.accuracy * 100.0);
     return out;
 }
+
+template performance::metrics performance::measure(const MatrixView<float>&, const MatrixView<float>&, loss::Type);
+template performance::metrics performance::measure(const MatrixView<double>&, const MatrixView<double>&, loss::Type);
+template double performance::agreement(const MatrixView<float>&, const MatrixView<float>&);
+template double performance::agreement(const MatrixView<double>&, const MatrixView<double>&);
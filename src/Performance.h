@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Loss.h"
+#include "MatrixView.h"
 #include <ostream>
 
 /**
@@ -16,6 +18,27 @@ namespace performance {
         double loss = 0.0;
         double accuracy = 0.0;
     };
+
+    /**
+     * @brief Computes the loss and accuracy of predictions against one-hot labels.
+     * @param predictions The predicted outputs, one sample per column.
+     * @param labels The one-hot labels, one sample per column.
+     * @param loss_type The type of loss function to use.
+     * @return A metrics object containing the loss and accuracy.
+     * @throws std::invalid_argument if the predictions and labels have different shapes.
+     */
+    template <typename T>
+    [[nodiscard]] metrics measure(const MatrixView<T>& predictions, const MatrixView<T>& labels, loss::Type loss_type);
+
+    /**
+     * @brief Computes the fraction of samples for which two sets of outputs predict the same class.
+     * @param lhs The first outputs, one sample per column.
+     * @param rhs The second outputs, one sample per column.
+     * @return Fraction of columns whose largest element is in the same row.
+     * @throws std::invalid_argument if the outputs have different shapes.
+     */
+    template <typename T>
+    [[nodiscard]] double agreement(const MatrixView<T>& lhs, const MatrixView<T>& rhs);
 }
 
 /**
@@ -0,0 +1,228 @@
+#include "Pool.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <format>
+#include <mutex>
+#include <new>
+
+/**
+ * @brief Base-2 logarithm of the smallest block size (one ALIGNMENT-sized block).
+ */
+static constexpr int MIN_SHIFT = std::countr_zero(pool::ALIGNMENT);
+
+/**
+ * @brief Number of size classes, from ALIGNMENT up to MAX_BLOCK bytes.
+ */
+static constexpr int CLASSES = std::countr_zero(pool::MAX_BLOCK) - MIN_SHIFT + 1;
+
+/**
+ * @brief Free block, linked through its own storage so returning it never allocates.
+ */
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+/**
+ * @brief Free lists and counters of the process-wide pool.
+ */
+struct PoolState {
+    std::mutex mutex;
+    std::array<FreeBlock*, CLASSES> free_lists {};
+    pool::Stats stats;
+};
+
+/**
+ * @brief Returns the process-wide pool state.
+ * @note The state is never destroyed, so matrices with static storage duration can still
+ * return their storage while the program exits.
+ */
+[[nodiscard]] static PoolState& state() noexcept {
+    static PoolState* instance = new PoolState;
+    return *instance;
+}
+
+/**
+ * @brief Returns the index of the smallest size class holding the given number of bytes.
+ */
+[[nodiscard]] static int size_class(std::size_t bytes) noexcept {
+    return std::max(static_cast<int>(std::bit_width(bytes - 1)), MIN_SHIFT) - MIN_SHIFT;
+}
+
+/**
+ * @brief Returns the block size of a size class, in bytes.
+ */
+[[nodiscard]] static std::size_t class_size(int index) noexcept {
+    return std::size_t { 1 } << (index + MIN_SHIFT);
+}
+
+/**
+ * @brief Requests an aligned block from the system.
+ */
+[[nodiscard]] static void* system_allocate(std::size_t bytes) {
+    return ::operator new(bytes, std::align_val_t { pool::ALIGNMENT });
+}
+
+/**
+ * @brief Returns an aligned block to the system.
+ */
+static void system_deallocate(void* block) noexcept {
+    ::operator delete(block, std::align_val_t { pool::ALIGNMENT });
+}
+
+void* pool::allocate(std::size_t bytes) {
+    bytes = std::max<std::size_t>(bytes, 1);
+    PoolState& pool = state();
+    const bool pooled = bytes <= MAX_BLOCK;
+    const int index = pooled ? size_class(bytes) : 0;
+    const std::size_t size = pooled ? class_size(index) : bytes;
+    {
+        std::scoped_lock lock { pool.mutex };
+        if (pooled && pool.free_lists[index] != nullptr) {
+            FreeBlock* block = pool.free_lists[index];
+            pool.free_lists[index] = block->next;
+            ++pool.stats.hits;
+            pool.stats.bytes_held -= size;
+            pool.stats.bytes_in_use += size;
+            return block;
+        }
+    }
+    void* block = system_allocate(size);
+    std::scoped_lock lock { pool.mutex };
+    ++pool.stats.misses;
+    pool.stats.bytes_in_use += size;
+    return block;
+}
+
+void pool::deallocate(void* block, std::size_t bytes) noexcept {
+    if (block == nullptr) {
+        return;
+    }
+    bytes = std::max<std::size_t>(bytes, 1);
+    PoolState& pool = state();
+    if (bytes > MAX_BLOCK) {
+        system_deallocate(block);
+        std::scoped_lock lock { pool.mutex };
+        pool.stats.bytes_in_use -= bytes;
+        return;
+    }
+    const int index = size_class(bytes);
+    const std::size_t size = class_size(index);
+    std::scoped_lock lock { pool.mutex };
+    pool.free_lists[index] = new (block) FreeBlock { pool.free_lists[index] };
+    pool.stats.bytes_held += size;
+    pool.stats.bytes_in_use -= size;
+}
+
+void pool::release() noexcept {
+    PoolState& pool = state();
+    std::scoped_lock lock { pool.mutex };
+    for (FreeBlock*& head : pool.free_lists) {
+        while (head != nullptr) {
+            FreeBlock* next = head->next;
+            system_deallocate(head);
+            head = next;
+        }
+    }
+    pool.stats.bytes_held = 0;
+}
+
+pool::Stats pool::stats() noexcept {
+    PoolState& pool = state();
+    std::scoped_lock lock { pool.mutex };
+    return pool.stats;
+}
+
+/**
+ * @brief Arena of the innermost scope open on each thread.
+ */
+static thread_local pool::Arena* active_arena = nullptr;
+
+/**
+ * @brief Smallest chunk requested by an arena, in bytes.
+ */
+static constexpr std::size_t MIN_CHUNK = std::size_t { 1 } << 16;
+
+pool::Arena::~Arena() {
+    for (const Chunk& chunk : chunks) {
+        pool::deallocate(chunk.data, chunk.size);
+    }
+}
+
+void* pool::Arena::allocate(std::size_t bytes) {
+    bytes = (std::max<std::size_t>(bytes, 1) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (chunks.empty() || offset + bytes > chunks.back().size) {
+        grow(bytes);
+    }
+    std::byte* block = chunks.back().data + offset;
+    offset += bytes;
+    used_bytes += bytes;
+    peak_bytes = std::max(peak_bytes, used_bytes);
+    return block;
+}
+
+void pool::Arena::reserve(std::size_t bytes) {
+    if (chunks.empty() || offset + bytes > chunks.back().size) {
+        grow(bytes);
+    }
+}
+
+void pool::Arena::reset() noexcept {
+    if (chunks.size() > 1) {
+        /* The cycle overflowed: keep a single chunk large enough for the whole peak */
+        const std::size_t size = std::bit_ceil(std::max(capacity(), MIN_CHUNK));
+        for (const Chunk& chunk : chunks) {
+            pool::deallocate(chunk.data, chunk.size);
+        }
+        chunks.clear();
+        try {
+            chunks.push_back({static_cast<std::byte*>(pool::allocate(size)), size});
+        } catch (const std::bad_alloc&) {
+            /* Leave the arena empty; the next allocation will grow it again */
+        }
+    }
+    offset = 0;
+    used_bytes = 0;
+    peak_bytes = 0;
+}
+
+std::size_t pool::Arena::capacity() const noexcept {
+    std::size_t total = 0;
+    for (const Chunk& chunk : chunks) {
+        total += chunk.size;
+    }
+    return total;
+}
+
+void pool::Arena::grow(std::size_t bytes) {
+    const std::size_t last = chunks.empty() ? 0 : chunks.back().size;
+    const std::size_t size = std::bit_ceil(std::max({bytes, 2 * last, MIN_CHUNK}));
+    chunks.reserve(chunks.size() + 1);
+    chunks.push_back({static_cast<std::byte*>(pool::allocate(size)), size});
+    offset = 0;
+}
+
+pool::ArenaScope::ArenaScope(Arena& arena) noexcept
+    : arena {arena}
+    , previous {active_arena}
+{
+    ++arena.depth;
+    active_arena = &arena;
+}
+
+pool::ArenaScope::~ArenaScope() {
+    active_arena = previous;
+    if (--arena.depth == 0) {
+        arena.reset();
+    }
+}
+
+pool::Arena* pool::current_arena() noexcept {
+    return active_arena;
+}
+
+std::ostream& operator<<(std::ostream& out, const pool::Stats& stats) {
+    out << std::format("Pool hits: {} | misses: {} | held: {:.1f} KiB | in use: {:.1f} KiB",
+        stats.hits, stats.misses, stats.bytes_held / 1024.0, stats.bytes_in_use / 1024.0);
+    return out;
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @namespace pool
+ * @brief Contains the process-wide memory pool backing the matrix storage.
+ * @details Requests are rounded up to a power-of-two size class and served from a free list
+ * of blocks previously returned for that class, so the buffers released by one training step
+ * are handed back to the next one instead of going through the global operator new.
+ * Every block is aligned to ALIGNMENT bytes.
+ *
+ * Short-lived temporaries can instead be drawn from an Arena: a bump allocator that is
+ * reset as a whole when the ArenaScope using it ends.
+ */
+namespace pool {
+
+    /**
+     * @brief Alignment, in bytes, of every block handed out by the pool (one cache line, one AVX-512 vector).
+     */
+    inline constexpr std::size_t ALIGNMENT = 64;
+
+    /**
+     * @brief Largest block size, in bytes, kept in the free lists; larger requests bypass the pool.
+     */
+    inline constexpr std::size_t MAX_BLOCK = std::size_t { 1 } << 30;
+
+    /**
+     * @struct Stats
+     * @brief Snapshot of the pool counters.
+     */
+    struct Stats {
+        std::size_t hits = 0;           ///< Allocations served from a free list
+        std::size_t misses = 0;         ///< Allocations that had to request memory from the system
+        std::size_t bytes_held = 0;     ///< Bytes cached in the free lists, ready to be reused
+        std::size_t bytes_in_use = 0;   ///< Bytes handed out and not yet returned
+    };
+
+    /**
+     * @brief Allocates an aligned block of at least the given size.
+     * @param bytes Number of bytes requested.
+     * @return Pointer to a block aligned to ALIGNMENT bytes.
+     * @throws std::bad_alloc if the system allocation fails.
+     */
+    [[nodiscard]] void* allocate(std::size_t bytes);
+
+    /**
+     * @brief Returns a block to the pool.
+     * @param block Pointer returned by allocate (nullptr is ignored).
+     * @param bytes The size passed to allocate for this block.
+     */
+    void deallocate(void* block, std::size_t bytes) noexcept;
+
+    /**
+     * @brief Returns the memory cached in the free lists to the system.
+     * @note Blocks currently in use are not affected.
+     */
+    void release() noexcept;
+
+    /**
+     * @brief Returns a snapshot of the pool counters.
+     * @return Current counters.
+     */
+    [[nodiscard]] Stats stats() noexcept;
+
+    /**
+     * @class Arena
+     * @brief Bump allocator for temporaries that all die at the same point, such as within one training step.
+     * @details Allocations advance an offset into a chunk drawn from the pool and are never freed one by one.
+     * reset releases everything at once; if the last cycle overflowed into extra chunks, they are merged
+     * into a single chunk of the peak size so the next cycle stays in one chunk and resets in O(1).
+     * @note An arena is not thread-safe; it is meant to be used by the thread that opened its scope.
+     */
+    class Arena {
+    public:
+        /**
+         * @brief Constructs an empty arena; the first chunk is allocated on first use.
+         */
+        Arena() = default;
+
+        /**
+         * @brief Returns all chunks to the pool.
+         */
+        ~Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /**
+         * @brief Allocates an aligned block that stays valid until the next reset.
+         * @param bytes Number of bytes requested.
+         * @return Pointer to a block aligned to ALIGNMENT bytes.
+         * @throws std::bad_alloc if a new chunk cannot be allocated.
+         */
+        [[nodiscard]] void* allocate(std::size_t bytes);
+
+        /**
+         * @brief Makes sure the next allocations, up to the given total, are served from the current chunk.
+         * @param bytes Total size of the upcoming allocations, each rounded up to ALIGNMENT bytes.
+         * @throws std::bad_alloc if a new chunk cannot be allocated.
+         * @note After a reservation on an empty arena, the allocations that follow are contiguous from data(),
+         * so they can be walked as one block.
+         */
+        void reserve(std::size_t bytes);
+
+        /**
+         * @brief Returns the start of the chunk allocations are currently served from.
+         * @return Start of the last chunk, or nullptr if the arena holds no chunk.
+         */
+        [[nodiscard]] std::byte* data() const noexcept { return chunks.empty() ? nullptr : chunks.back().data; }
+
+        /**
+         * @brief Releases every allocation made since the last reset.
+         */
+        void reset() noexcept;
+
+        /**
+         * @brief Returns the number of bytes allocated since the last reset.
+         * @return Bytes in use.
+         */
+        [[nodiscard]] std::size_t used() const noexcept { return used_bytes; }
+
+        /**
+         * @brief Returns the highest number of bytes in use since the last reset.
+         * @return Peak bytes in use.
+         */
+        [[nodiscard]] std::size_t peak() const noexcept { return peak_bytes; }
+
+        /**
+         * @brief Returns the total size of the chunks owned by the arena.
+         * @return Capacity in bytes.
+         */
+        [[nodiscard]] std::size_t capacity() const noexcept;
+    private:
+        friend class ArenaScope;
+
+        /**
+         * @struct Chunk
+         * @brief Block of memory carved up by the arena.
+         */
+        struct Chunk {
+            std::byte* data;    ///< Start of the chunk
+            std::size_t size;   ///< Size of the chunk in bytes
+        };
+
+        /**
+         * @brief Chunks owned by the arena; allocations are served from the last one.
+         */
+        std::vector<Chunk> chunks;
+
+        /**
+         * @brief Offset of the next free byte in the last chunk.
+         */
+        std::size_t offset = 0;
+
+        /**
+         * @brief Bytes allocated since the last reset.
+         */
+        std::size_t used_bytes = 0;
+
+        /**
+         * @brief Highest value of used_bytes since the last reset.
+         */
+        std::size_t peak_bytes = 0;
+
+        /**
+         * @brief Number of open scopes using the arena; it is only reset when the outermost one closes.
+         */
+        int depth = 0;
+
+        /**
+         * @brief Adds a chunk able to hold at least the given number of bytes.
+         */
+        void grow(std::size_t bytes);
+    };
+
+    /**
+     * @class ArenaScope
+     * @brief Makes an arena the current one for the calling thread until the scope ends, then resets it.
+     * @details Scopes can be nested; the arena is only reset when the outermost scope using it ends.
+     */
+    class ArenaScope {
+    public:
+        /**
+         * @brief Opens a scope on an arena.
+         * @param arena The arena serving Matrix::scratch requests while the scope is open.
+         */
+        explicit ArenaScope(Arena& arena) noexcept;
+
+        /**
+         * @brief Restores the previous arena and resets this one if the scope is the outermost.
+         */
+        ~ArenaScope();
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+        /**
+         * @brief Returns the highest number of bytes the arena has held during the scope.
+         * @return Peak bytes in use.
+         */
+        [[nodiscard]] std::size_t peak() const noexcept { return arena.peak(); }
+    private:
+        /**
+         * @brief The arena of the scope.
+         */
+        Arena& arena;
+
+        /**
+         * @brief Arena that was current when the scope was opened.
+         */
+        Arena* previous;
+    };
+
+    /**
+     * @brief Returns the arena of the innermost scope open on the calling thread.
+     * @return The current arena, or nullptr if no scope is open.
+     */
+    [[nodiscard]] Arena* current_arena() noexcept;
+
+    /**
+     * @class Allocator
+     * @brief Standard allocator drawing from the pool, or from an arena when given one.
+     * @details Copies of a container always go back to the pool, so a temporary that is copied out
+     * of an arena scope survives it. Moving keeps the arena.
+     * @tparam T Element type.
+     */
+    template <typename T>
+    class Allocator {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::false_type;
+        using propagate_on_container_move_assignment = std::false_type;
+        using propagate_on_container_swap = std::false_type;
+        using is_always_equal = std::false_type;
+
+        /**
+         * @brief Constructs an allocator drawing from the pool.
+         */
+        Allocator() noexcept = default;
+
+        /**
+         * @brief Constructs an allocator drawing from an arena.
+         * @param arena The arena to draw from (nullptr = pool).
+         */
+        explicit Allocator(Arena* arena) noexcept : m_arena {arena} {}
+
+        template <typename U>
+        Allocator(const Allocator<U>& other) noexcept : m_arena {other.arena()} {}
+
+        [[nodiscard]] T* allocate(std::size_t n) {
+            void* block = m_arena ? m_arena->allocate(n * sizeof(T)) : pool::allocate(n * sizeof(T));
+            return static_cast<T*>(block);
+        }
+
+        void deallocate(T* block, std::size_t n) noexcept {
+            if (!m_arena) {
+                pool::deallocate(block, n * sizeof(T));
+            }
+        }
+
+        [[nodiscard]] Allocator select_on_container_copy_construction() const noexcept {
+            return Allocator {};
+        }
+
+        [[nodiscard]] Arena* arena() const noexcept { return m_arena; }
+
+        template <typename U>
+        friend bool operator==(const Allocator& lhs, const Allocator<U>& rhs) noexcept {
+            return lhs.arena() == rhs.arena();
+        }
+    private:
+        /**
+         * @brief The arena to draw from, or nullptr to use the pool.
+         */
+        Arena* m_arena = nullptr;
+    };
+}
+
+/**
+ * @brief Outputs the pool counters to a stream.
+ * @param out Output stream.
+ * @param stats Pool counters to output.
+ * @return Reference to the output stream.
+ */
+std::ostream& operator<<(std::ostream& out, const pool::Stats& stats);
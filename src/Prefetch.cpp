@@ -0,0 +1,8 @@
+#include "Prefetch.h"
+#include <format>
+
+std::ostream& operator<<(std::ostream& out, const prefetch::Stats& stats) {
+    out << std::format("Prefetch stalls: {} of {} batches | {:.2f} ms",
+        stats.stalls, stats.batches, stats.stall_ms);
+    return out;
+}
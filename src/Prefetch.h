@@ -0,0 +1,412 @@
+#pragma once
+
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+/**
+ * @namespace prefetch
+ * @brief Contains the pipeline assembling training batches in the background.
+ * @details Worker threads fill the batches ahead of the training thread into rings of
+ * reusable slots, and hand them over in order through single-producer single-consumer queues.
+ */
+namespace prefetch {
+
+    /**
+     * @struct Settings
+     * @brief Contains settings for the batch pipeline.
+     */
+    struct Settings {
+        int workers = 1;    ///< Threads assembling batches (default = 1; 0 = assemble them on the training thread)
+        int depth = 4;      ///< Batches each worker keeps ready ahead of training (default = 4)
+    };
+
+    /**
+     * @struct Stats
+     * @brief Counters of the batches handed to the training thread.
+     */
+    struct Stats {
+        std::size_t batches = 0;    ///< Batches consumed
+        std::size_t stalls = 0;     ///< Batches that were not ready when the training thread asked for them
+        double stall_ms = 0.0;      ///< Time the training thread spent waiting for batches, in milliseconds
+    };
+
+    /**
+     * @class Ring
+     * @brief Lock-free single-producer single-consumer queue over a fixed ring of reusable slots.
+     * @details The producer fills the slot at head and publishes it; the consumer reads the slot at
+     * tail and releases it once it is done with it, so slots are recycled without copies or allocations.
+     * Each index is written by one side only, and a side waits on the other's index only when the
+     * ring is full or empty.
+     * @tparam Slot Type of the slots.
+     */
+    template <typename Slot>
+    class Ring {
+    public:
+        /**
+         * @brief Constructs a ring of slots.
+         * @param capacity Number of slots (values below 1 are treated as 1).
+         * @param make Function returning a new slot.
+         */
+        template <typename Make>
+        Ring(int capacity, Make&& make);
+
+        /**
+         * @brief Returns the free slot at head, waiting while the ring is full (producer side).
+         * @param stop Flag checked while waiting.
+         * @return The slot to fill, or nullptr once stop is set.
+         */
+        [[nodiscard]] Slot* claim(const std::atomic<bool>& stop);
+
+        /**
+         * @brief Hands the slot returned by claim over to the consumer (producer side).
+         */
+        void publish() noexcept;
+
+        /**
+         * @brief Marks the ring as failed and wakes up the consumer (producer side).
+         */
+        void close() noexcept;
+
+        /**
+         * @brief Returns the oldest published slot, waiting while the ring is empty (consumer side).
+         * @param stalled Set to whether the ring was empty.
+         * @return The slot to read, or nullptr if the producer closed the ring instead of filling it.
+         */
+        [[nodiscard]] Slot* front(bool& stalled);
+
+        /**
+         * @brief Gives the slot returned by front back to the producer (consumer side).
+         */
+        void pop() noexcept;
+
+        /**
+         * @brief Frees every slot so that a producer waiting in claim wakes up (consumer side).
+         * @note The ring must not be used afterwards.
+         */
+        void drain() noexcept;
+    private:
+        /**
+         * @brief Slots of the ring, indexed modulo their number.
+         */
+        std::vector<Slot> slots;
+
+        /**
+         * @brief Number of slots published so far, written by the producer.
+         */
+        alignas(64) std::atomic<std::size_t> head {0};
+
+        /**
+         * @brief Number of slots released so far, written by the consumer.
+         */
+        alignas(64) std::atomic<std::size_t> tail {0};
+
+        /**
+         * @brief Index of the slot the producer failed to fill, set by close.
+         */
+        std::atomic<std::size_t> failed_at {std::numeric_limits<std::size_t>::max()};
+    };
+
+    /**
+     * @class Pipeline
+     * @brief Fills a sequence of batches on worker threads and hands them to one consumer in order.
+     * @details Worker w fills the batches w, w + workers, w + 2 * workers, ... into its own ring,
+     * so each ring has one producer and the consumer reads the rings in turn. Workers do not run
+     * past the limit set by open, which lets the consumer prepare what a batch depends on (such
+     * as the shuffled order of an epoch) before any worker reads it. The parallel calls made by
+     * the workers run serially, since the workers already run concurrently with the pool.
+     * @tparam Slot Type of the batches.
+     */
+    template <typename Slot>
+    class Pipeline {
+    public:
+        /**
+         * @brief Constructs a pipeline and starts its workers.
+         * @param settings The pipeline settings.
+         * @param batches Total number of batches to fill.
+         * @param make Function returning a new, empty slot.
+         * @param fill Function filling a slot with the batch of a given index; must be safe to call concurrently.
+         * @note No batch is filled before open is called.
+         */
+        template <typename Make>
+        Pipeline(const Settings& settings, std::size_t batches, Make&& make, std::function<void(Slot&, std::size_t)> fill);
+
+        /**
+         * @brief Stops the workers and waits for them to exit.
+         */
+        ~Pipeline();
+
+        Pipeline(const Pipeline&) = delete;
+        Pipeline& operator=(const Pipeline&) = delete;
+
+        /**
+         * @brief Allows the workers to fill every batch below a given index.
+         * @param count Number of batches that may be filled; values lower than a previous call are ignored.
+         */
+        void open(std::size_t count) noexcept;
+
+        /**
+         * @brief Returns the next batch, waiting for it if it is not ready yet.
+         * @return The batch, valid until release is called.
+         * @throws Rethrows the exception thrown by fill for this batch.
+         * @note Must be followed by release before the next call.
+         */
+        [[nodiscard]] Slot& next();
+
+        /**
+         * @brief Gives the batch returned by next back to its worker.
+         */
+        void release() noexcept;
+
+        /**
+         * @brief Returns the counters accumulated since the last reset.
+         * @return The counters.
+         */
+        [[nodiscard]] const Stats& stats() const noexcept { return counters; }
+
+        /**
+         * @brief Resets the counters.
+         */
+        void reset_stats() noexcept { counters = {}; }
+    private:
+        /**
+         * @struct Worker
+         * @brief A worker thread and the ring it fills.
+         */
+        struct Worker {
+            Ring<Slot> ring;
+            std::exception_ptr error;   ///< Exception thrown by fill, rethrown by next
+
+            template <typename Make>
+            Worker(int depth, Make& make) : ring {depth, make} {}
+        };
+
+        /**
+         * @brief Function filling a slot with a batch.
+         */
+        std::function<void(Slot&, std::size_t)> fill;
+
+        /**
+         * @brief Total number of batches.
+         */
+        std::size_t batches;
+
+        /**
+         * @brief Index of the next batch handed to the consumer.
+         */
+        std::size_t consumed = 0;
+
+        /**
+         * @brief Slot used when batches are filled on the consumer thread (no workers).
+         */
+        std::vector<Slot> inline_slot;
+
+        /**
+         * @brief Workers and their rings; empty when batches are filled on the consumer thread.
+         * @note Held by pointer because a ring holds atomics and cannot be moved.
+         */
+        std::vector<std::unique_ptr<Worker>> workers;
+
+        /**
+         * @brief Number of batches the workers may fill.
+         */
+        std::atomic<std::size_t> limit {0};
+
+        /**
+         * @brief Set when the pipeline is being destroyed.
+         */
+        std::atomic<bool> stopping {false};
+
+        /**
+         * @brief Counters since the last reset.
+         */
+        Stats counters;
+
+        /**
+         * @brief Worker threads, declared last so they are joined before the rings are destroyed.
+         */
+        std::vector<std::jthread> threads;
+
+        /**
+         * @brief Main loop of a worker thread.
+         * @param index Index of the worker.
+         */
+        void run(std::size_t index);
+    };
+}
+
+/**
+ * @brief Outputs pipeline counters to a stream.
+ * @param out Output stream.
+ * @param stats Pipeline counters to output.
+ * @return Reference to the output stream.
+ */
+std::ostream& operator<<(std::ostream& out, const prefetch::Stats& stats);
+
+template <typename Slot>
+template <typename Make>
+prefetch::Ring<Slot>::Ring(int capacity, Make&& make) {
+    slots.reserve(static_cast<std::size_t>(std::max(capacity, 1)));
+    for (int slot { 0 }; slot < std::max(capacity, 1); ++slot) {
+        slots.push_back(make());
+    }
+}
+
+template <typename Slot>
+Slot* prefetch::Ring<Slot>::claim(const std::atomic<bool>& stop) {
+    const std::size_t h = head.load(std::memory_order_relaxed);
+    for (std::size_t t = tail.load(std::memory_order_acquire); h - t == slots.size(); t = tail.load(std::memory_order_acquire)) {
+        if (stop.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        tail.wait(t, std::memory_order_acquire);
+    }
+    return stop.load(std::memory_order_acquire) ? nullptr : &slots[h % slots.size()];
+}
+
+template <typename Slot>
+void prefetch::Ring<Slot>::publish() noexcept {
+    head.fetch_add(1, std::memory_order_release);
+    head.notify_one();
+}
+
+template <typename Slot>
+void prefetch::Ring<Slot>::close() noexcept {
+    /* Bumping head wakes a consumer waiting on an empty ring; it checks failed_at before reading the slot */
+    failed_at.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    head.fetch_add(1, std::memory_order_release);
+    head.notify_one();
+}
+
+template <typename Slot>
+Slot* prefetch::Ring<Slot>::front(bool& stalled) {
+    const std::size_t t = tail.load(std::memory_order_relaxed);
+    std::size_t h = head.load(std::memory_order_acquire);
+    stalled = h == t;
+    for (; h == t; h = head.load(std::memory_order_acquire)) {
+        head.wait(h, std::memory_order_acquire);
+    }
+    return t == failed_at.load(std::memory_order_relaxed) ? nullptr : &slots[t % slots.size()];
+}
+
+template <typename Slot>
+void prefetch::Ring<Slot>::pop() noexcept {
+    tail.fetch_add(1, std::memory_order_release);
+    tail.notify_one();
+}
+
+template <typename Slot>
+void prefetch::Ring<Slot>::drain() noexcept {
+    tail.fetch_add(slots.size(), std::memory_order_release);
+    tail.notify_one();
+}
+
+template <typename Slot>
+template <typename Make>
+prefetch::Pipeline<Slot>::Pipeline(
+    const Settings& settings,
+    std::size_t batches,
+    Make&& make,
+    std::function<void(Slot&, std::size_t)> fill
+)
+    : fill {std::move(fill)}
+    , batches {batches}
+{
+    if (settings.workers <= 0) {
+        inline_slot.push_back(make());
+        return;
+    }
+    for (int worker { 0 }; worker < settings.workers; ++worker) {
+        workers.push_back(std::make_unique<Worker>(settings.depth, make));
+    }
+    for (std::size_t worker { 0 }; worker < workers.size(); ++worker) {
+        threads.emplace_back([this, worker] { run(worker); });
+    }
+}
+
+template <typename Slot>
+prefetch::Pipeline<Slot>::~Pipeline() {
+    stopping.store(true, std::memory_order_release);
+    limit.store(std::numeric_limits<std::size_t>::max(), std::memory_order_release);
+    limit.notify_all();
+    for (auto& worker : workers) {
+        worker->ring.drain();
+    }
+    threads.clear();
+}
+
+template <typename Slot>
+void prefetch::Pipeline<Slot>::open(std::size_t count) noexcept {
+    if (count > limit.load(std::memory_order_relaxed)) {
+        limit.store(count, std::memory_order_release);
+        limit.notify_all();
+    }
+}
+
+template <typename Slot>
+Slot& prefetch::Pipeline<Slot>::next() {
+    using clock = std::chrono::steady_clock;
+    ++counters.batches;
+
+    /* Without workers the consumer fills the batch itself, and all of that time is a stall */
+    if (workers.empty()) {
+        const auto start = clock::now();
+        fill(inline_slot.front(), consumed);
+        ++counters.stalls;
+        counters.stall_ms += std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        return inline_slot.front();
+    }
+
+    Worker& worker = *workers[consumed % workers.size()];
+    const auto start = clock::now();
+    bool stalled = false;
+    Slot* slot = worker.ring.front(stalled);
+    if (stalled) {
+        ++counters.stalls;
+        counters.stall_ms += std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    }
+    if (!slot) {
+        std::rethrow_exception(worker.error);
+    }
+    return *slot;
+}
+
+template <typename Slot>
+void prefetch::Pipeline<Slot>::release() noexcept {
+    if (!workers.empty()) {
+        workers[consumed % workers.size()]->ring.pop();
+    }
+    ++consumed;
+}
+
+template <typename Slot>
+void prefetch::Pipeline<Slot>::run(std::size_t index) {
+    parallel::run_serially();
+    Worker& worker = *workers[index];
+    for (std::size_t batch { index }; batch < batches; batch += workers.size()) {
+        for (std::size_t open = limit.load(std::memory_order_acquire); batch >= open; open = limit.load(std::memory_order_acquire)) {
+            limit.wait(open, std::memory_order_acquire);
+        }
+        Slot* slot = worker.ring.claim(stopping);
+        if (!slot) {
+            return;
+        }
+        try {
+            fill(*slot, batch);
+        } catch (...) {
+            worker.error = std::current_exception();
+            worker.ring.close();
+            return;
+        }
+        worker.ring.publish();
+    }
+}
@@ -0,0 +1,436 @@
+#include "Quantized.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cpuid.h>
+#include <format>
+#include <immintrin.h>
+#include <stdexcept>
+
+/**
+ * @brief Row length, in bytes, the quantized weights and activations are padded to (one AVX-512 vector).
+ */
+static constexpr int QUANT_ALIGN = 64;
+
+/**
+ * @brief Largest magnitude of a quantized weight; -128 is left out so the range is symmetric.
+ */
+static constexpr int WEIGHT_LEVELS = 127;
+
+/**
+ * @brief Largest quantized activation.
+ */
+static constexpr int ACTIVATION_LEVELS = 255;
+
+/**
+ * @brief Number of weight rows sharing each load of an activation vector in the kernels.
+ */
+static constexpr int ROW_BLOCK = 4;
+
+/**
+ * @brief Number of samples whose activations stay in L1 while every weight row passes over them.
+ */
+static constexpr int SAMPLE_BLOCK = 16;
+
+/**
+ * @brief Int8 product kernel: c[i * ldc + j] = dot(w row i, a row j) over stride bytes, for m rows and n samples.
+ */
+using GemmKernel = void (*)(const int8_t* w, int m, const uint8_t* a, int n, int stride, int32_t* c, int ldc) noexcept;
+
+/* Scalar */
+
+namespace scalar {
+
+    static void gemm(const int8_t* w, int m, const uint8_t* a, int n, int stride, int32_t* c, int ldc) noexcept {
+        for (int i { 0 }; i < m; ++i) {
+            for (int j { 0 }; j < n; ++j) {
+                int32_t sum = 0;
+                for (int k { 0 }; k < stride; ++k) {
+                    sum += static_cast<int32_t>(w[i * stride + k]) * static_cast<int32_t>(a[j * stride + k]);
+                }
+                c[i * ldc + j] = sum;
+            }
+        }
+    }
+}
+
+/* AVX2: operands widened to int16, pairs summed into int32 by vpmaddwd (no saturation) */
+
+namespace avx2 {
+
+    [[gnu::target("avx2")]] static inline int32_t reduce(__m256i x) noexcept {
+        __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(sum);
+    }
+
+    template <int R>
+    [[gnu::target("avx2")]] static void rows(const int8_t* w, const uint8_t* a, int n, int stride, int32_t* c, int ldc) noexcept {
+        for (int j { 0 }; j < n; ++j) {
+            const uint8_t* sample = a + j * stride;
+            __m256i acc[R];
+            for (int r { 0 }; r < R; ++r) {
+                acc[r] = _mm256_setzero_si256();
+            }
+            for (int k { 0 }; k < stride; k += 16) {
+                const __m256i x = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sample + k)));
+                for (int r { 0 }; r < R; ++r) {
+                    const __m256i y = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w + r * stride + k)));
+                    acc[r] = _mm256_add_epi32(acc[r], _mm256_madd_epi16(x, y));
+                }
+            }
+            for (int r { 0 }; r < R; ++r) {
+                c[r * ldc + j] = reduce(acc[r]);
+            }
+        }
+    }
+
+    [[gnu::target("avx2")]] static void gemm(const int8_t* w, int m, const uint8_t* a, int n, int stride, int32_t* c, int ldc) noexcept {
+        for (int j { 0 }; j < n; j += SAMPLE_BLOCK) {
+            const int count = std::min(SAMPLE_BLOCK, n - j);
+            int i { 0 };
+            for (; i + ROW_BLOCK <= m; i += ROW_BLOCK) {
+                rows<ROW_BLOCK>(w + i * stride, a + j * stride, count, stride, c + i * ldc + j, ldc);
+            }
+            for (; i < m; ++i) {
+                rows<1>(w + i * stride, a + j * stride, count, stride, c + i * ldc + j, ldc);
+            }
+        }
+    }
+}
+
+/* AVX-VNNI: vpdpbusd on 256-bit vectors, four u8 x s8 products summed into each int32 lane */
+
+namespace avx_vnni {
+
+    template <int R>
+    [[gnu::target("avx2,avxvnni")]] static void rows(const int8_t* w, const uint8_t* a, int n, int stride, int32_t* c, int ldc) noexcept {
+        for (int j { 0 }; j < n; ++j) {
+            const uint8_t* sample = a + j * stride;
+            __m256i acc[R];
+            for (int r { 0 }; r < R; ++r) {
+                acc[r] = _mm256_setzero_si256();
+            }
+            for (int k { 0 }; k < stride; k += 32) {
+                const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sample + k));
+                for (int r { 0 }; r < R; ++r) {
+                    const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + r * stride + k));
+                    acc[r] = _mm256_dpbusd_avx_epi32(acc[r], x, y);
+                }
+            }
+            for (int r { 0 }; r < R; ++r) {
+                c[r * ldc + j] = avx2::reduce(acc[r]);
+            }
+        }
+    }
+
+    [[gnu::target("avx2,avxvnni")]] static void gemm(const int8_t* w, int m, const uint8_t* a, int n, int stride, int32_t* c, int ldc) noexcept {
+        for (int j { 0 }; j < n; j += SAMPLE_BLOCK) {
+            const int count = std::min(SAMPLE_BLOCK, n - j);
+            int i { 0 };
+            for (; i + ROW_BLOCK <= m; i += ROW_BLOCK) {
+                rows<ROW_BLOCK>(w + i * stride, a + j * stride, count, stride, c + i * ldc + j, ldc);
+            }
+            for (; i < m; ++i) {
+                rows<1>(w + i * stride, a + j * stride, count, stride, c + i * ldc + j, ldc);
+            }
+        }
+    }
+}
+
+/* AVX-512 VNNI: vpdpbusd on 512-bit vectors */
+
+namespace avx512_vnni {
+
+    [[gnu::target("avx512f,avx512bw,avx512vnni")]] static inline int32_t reduce(__m512i x) noexcept {
+        return avx2::reduce(_mm256_add_epi32(_mm512_maskz_extracti64x4_epi64(0xFF, x, 0), _mm512_maskz_extracti64x4_epi64(0xFF, x, 1)));
+    }
+
+    template <int R>
+    [[gnu::target("avx512f,avx512bw,avx512vnni")]] static void rows(const int8_t* w, const uint8_t* a, int n, int stride, int32_t* c, int ldc) noexcept {
+        for (int j { 0 }; j < n; ++j) {
+            const uint8_t* sample = a + j * stride;
+            __m512i acc[R];
+            for (int r { 0 }; r < R; ++r) {
+                acc[r] = _mm512_setzero_si512();
+            }
+            for (int k { 0 }; k < stride; k += 64) {
+                const __m512i x = _mm512_loadu_si512(sample + k);
+                for (int r { 0 }; r < R; ++r) {
+                    acc[r] = _mm512_dpbusd_epi32(acc[r], x, _mm512_loadu_si512(w + r * stride + k));
+                }
+            }
+            for (int r { 0 }; r < R; ++r) {
+                c[r * ldc + j] = reduce(acc[r]);
+            }
+        }
+    }
+
+    [[gnu::target("avx512f,avx512bw,avx512vnni")]] static void gemm(const int8_t* w, int m, const uint8_t* a, int n, int stride, int32_t* c, int ldc) noexcept {
+        for (int j { 0 }; j < n; j += SAMPLE_BLOCK) {
+            const int count = std::min(SAMPLE_BLOCK, n - j);
+            int i { 0 };
+            for (; i + ROW_BLOCK <= m; i += ROW_BLOCK) {
+                rows<ROW_BLOCK>(w + i * stride, a + j * stride, count, stride, c + i * ldc + j, ldc);
+            }
+            for (; i < m; ++i) {
+                rows<1>(w + i * stride, a + j * stride, count, stride, c + i * ldc + j, ldc);
+            }
+        }
+    }
+}
+
+/* Dispatch */
+
+/**
+ * @struct Kernel
+ * @brief Int8 product kernel selected for the running CPU.
+ */
+struct Kernel {
+    std::string_view name;
+    GemmKernel gemm;
+};
+
+/**
+ * @brief Checks for AVX-VNNI (CPUID leaf 7, sub-leaf 1, EAX bit 4), which __builtin_cpu_supports does not report.
+ */
+[[nodiscard]] static bool has_avx_vnni() noexcept {
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    return __builtin_cpu_supports("avx2")
+        && __get_cpuid_count(7, 1, &eax, &ebx, &ecx, &edx)
+        && (eax & (1u << 4)) != 0;
+}
+
+/**
+ * @brief Picks the widest kernel supported by the running CPU.
+ */
+[[nodiscard]] static Kernel select() noexcept {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512vnni") && __builtin_cpu_supports("avx512bw")) {
+        return {"AVX-512 VNNI", avx512_vnni::gemm};
+    }
+    if (has_avx_vnni()) {
+        return {"AVX-VNNI", avx_vnni::gemm};
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return {"AVX2", avx2::gemm};
+    }
+    return {"scalar", scalar::gemm};
+}
+
+/**
+ * @brief Returns the kernel for the running CPU, selecting it on first use.
+ */
+[[nodiscard]] static const Kernel& kernel() noexcept {
+    static const Kernel selected = select();
+    return selected;
+}
+
+std::string_view quantization::kernel_name() noexcept {
+    return kernel().name;
+}
+
+/**
+ * @brief Arena holding the temporaries of one prediction, reset when it ends.
+ */
+static thread_local pool::Arena inference_arena;
+
+/**
+ * @brief Rounds a row length up to a multiple of QUANT_ALIGN.
+ */
+[[nodiscard]] static int padded(int length) noexcept {
+    return (length + QUANT_ALIGN - 1) / QUANT_ALIGN * QUANT_ALIGN;
+}
+
+template <typename T>
+template <typename Master>
+QuantizedNetwork<T>::QuantizedNetwork(const NeuralNetwork<T, Master>& network, const quantization::Settings& settings) {
+    for (const auto& layer : network.get_layers()) {
+        layers.push_back(quantize_layer(layer.weights(), layer.biases(), layer.activation_type(), settings.granularity));
+    }
+}
+
+template <typename T>
+typename QuantizedNetwork<T>::QuantizedLayer QuantizedNetwork<T>::quantize_layer(
+    const MatrixView<T>& weights,
+    const MatrixView<T>& biases,
+    activation::Type activation,
+    quantization::Granularity granularity
+) {
+    const int output = weights.rows();
+    const int input = weights.cols();
+    QuantizedLayer layer {
+        .input = input,
+        .output = output,
+        .stride = padded(input),
+        .weights = {},
+        .scales = std::vector<float>(static_cast<size_t>(output)),
+        .row_sums = std::vector<int32_t>(static_cast<size_t>(output)),
+        .biases = std::vector<T>(static_cast<size_t>(output)),
+        .activation = activation,
+    };
+    layer.weights.resize(static_cast<size_t>(output) * static_cast<size_t>(layer.stride));
+
+    /* Symmetric scales: the largest magnitude of the row (or layer) maps to WEIGHT_LEVELS */
+    std::vector<double> magnitude(static_cast<size_t>(output));
+    for (int row { 0 }; row < output; ++row) {
+        for (int col { 0 }; col < input; ++col) {
+            magnitude[row] = std::max(magnitude[row], std::abs(static_cast<double>(weights[row, col])));
+        }
+    }
+    if (granularity == quantization::Granularity::PerLayer) {
+        std::fill(magnitude.begin(), magnitude.end(), *std::max_element(magnitude.begin(), magnitude.end()));
+    }
+
+    for (int row { 0 }; row < output; ++row) {
+        const double scale = magnitude[row] > 0.0 ? magnitude[row] / WEIGHT_LEVELS : 1.0;
+        int32_t sum = 0;
+        for (int col { 0 }; col < input; ++col) {
+            const long level = std::lround(static_cast<double>(weights[row, col]) / scale);
+            const int8_t q = static_cast<int8_t>(std::clamp<long>(level, -WEIGHT_LEVELS, WEIGHT_LEVELS));
+            layer.weights[static_cast<size_t>(row) * layer.stride + col] = q;
+            sum += q;
+        }
+        layer.scales[row] = static_cast<float>(scale);
+        layer.row_sums[row] = sum;
+        layer.biases[row] = biases[row, 0];
+    }
+    return layer;
+}
+
+template <typename T>
+void QuantizedNetwork<T>::predict_layer(const QuantizedLayer& layer, Matrix<T>& out, const MatrixView<T>& input) {
+    const int samples = input.cols();
+    const int stride = layer.stride;
+
+    /* Samples as contiguous rows, so each one is quantized and multiplied in place */
+    Matrix<T> rows = Matrix<T>::scratch(samples, layer.input);
+    transpose_into(rows, input);
+
+    const pool::Allocator<uint8_t> bytes { pool::current_arena() };
+    std::vector<uint8_t, pool::Allocator<uint8_t>> quantized(static_cast<size_t>(samples) * stride, 0, bytes);
+    std::vector<float> scales(static_cast<size_t>(samples));
+    std::vector<int32_t> zero_points(static_cast<size_t>(samples));
+    std::vector<int32_t, pool::Allocator<int32_t>> products(
+        static_cast<size_t>(layer.output) * samples, 0, pool::Allocator<int32_t> { pool::current_arena() });
+    Matrix<T> linear = Matrix<T>::scratch(layer.output, samples);
+
+    parallel::for_each_chunk(static_cast<size_t>(samples), 16, [&](size_t first, size_t last) {
+        /* Asymmetric per-sample activations: [min, max], widened to include 0, maps to [0, ACTIVATION_LEVELS] */
+        for (int j { static_cast<int>(first) }; j < static_cast<int>(last); ++j) {
+            const T* values = &rows[j, 0];
+            T min = 0, max = 0;
+            for (int k { 0 }; k < layer.input; ++k) {
+                min = std::min(min, values[k]);
+                max = std::max(max, values[k]);
+            }
+            const double scale = max > min ? (static_cast<double>(max) - min) / ACTIVATION_LEVELS : 1.0;
+            const int32_t zero_point = static_cast<int32_t>(std::lround(-min / scale));
+
+            /* Levels are non-negative once offset, so adding 0.5 and truncating rounds to nearest */
+            const T inverse = static_cast<T>(1.0 / scale);
+            const T offset = static_cast<T>(zero_point) + static_cast<T>(0.5);
+            uint8_t* q = quantized.data() + static_cast<size_t>(j) * stride;
+            for (int k { 0 }; k < layer.input; ++k) {
+                const T level = std::clamp(values[k] * inverse + offset, static_cast<T>(0), static_cast<T>(ACTIVATION_LEVELS));
+                q[k] = static_cast<uint8_t>(static_cast<int>(level));
+            }
+            scales[j] = static_cast<float>(scale);
+            zero_points[j] = zero_point;
+        }
+
+        const int count = static_cast<int>(last - first);
+        kernel().gemm(layer.weights.data(), layer.output,
+            quantized.data() + first * stride, count, stride,
+            products.data() + first, samples);
+
+        /* Back to floating point: the zero point contributes zero_point * row_sum to every accumulator */
+        for (int i { 0 }; i < layer.output; ++i) {
+            for (int j { static_cast<int>(first) }; j < static_cast<int>(last); ++j) {
+                const int32_t accumulator = products[static_cast<size_t>(i) * samples + j] - zero_points[j] * layer.row_sums[i];
+                linear[i, j] = static_cast<T>(layer.scales[i] * scales[j] * static_cast<float>(accumulator)) + layer.biases[i];
+            }
+        }
+    }, static_cast<size_t>(layer.output) * static_cast<size_t>(samples) * static_cast<size_t>(layer.input));
+
+    activation::apply_into(out, linear, layer.activation);
+}
+
+template <typename T>
+Matrix<T> QuantizedNetwork<T>::predict(const MatrixView<T>& input) const {
+    if (input.rows() != layers.front().input) {
+        throw std::invalid_argument(std::format(
+            "mismatched input rows {} must be {}", input.rows(), layers.front().input
+        ));
+    }
+    /* Intermediate activations live in the arena; only the final output is copied out of it */
+    pool::ArenaScope scope { inference_arena };
+    Matrix<T> a = Matrix<T>::scratch(1, 1);
+    Matrix<T> next = Matrix<T>::scratch(1, 1);
+    predict_layer(layers.front(), a, input);
+    for (size_t i { 1 }; i < layers.size(); ++i) {
+        predict_layer(layers[i], next, a);
+        std::swap(a, next);
+    }
+    return Matrix<T> { a.view() };
+}
+
+template <typename T>
+performance::metrics QuantizedNetwork<T>::evaluate(const MatrixView<T>& input, const MatrixView<T>& labels, loss::Type loss_type) const {
+    const Matrix<T> pred = predict(input);
+    return performance::measure(pred.view(), labels, loss_type);
+}
+
+template <typename T>
+template <typename Master>
+quantization::Report QuantizedNetwork<T>::compare(
+    const NeuralNetwork<T, Master>& reference,
+    const MatrixView<T>& input,
+    const MatrixView<T>& labels,
+    loss::Type loss_type
+) const {
+    const Matrix<T> expected = reference.predict(input);
+    const Matrix<T> actual = predict(input);
+    std::size_t reference_bytes = 0;
+    for (const auto& layer : reference.get_layers()) {
+        reference_bytes += static_cast<std::size_t>(layer.weights().rows()) * layer.weights().cols() * sizeof(T);
+    }
+    return {
+        .reference = performance::measure(expected.view(), labels, loss_type),
+        .quantized = performance::measure(actual.view(), labels, loss_type),
+        .agreement = performance::agreement(expected.view(), actual.view()),
+        .reference_bytes = reference_bytes,
+        .quantized_bytes = weight_bytes(),
+    };
+}
+
+template <typename T>
+std::size_t QuantizedNetwork<T>::weight_bytes() const noexcept {
+    std::size_t total = 0;
+    for (const auto& layer : layers) {
+        total += static_cast<std::size_t>(layer.output) * layer.input * sizeof(int8_t) + layer.scales.size() * sizeof(float);
+    }
+    return total;
+}
+
+std::ostream& operator<<(std::ostream& out, const quantization::Report& report) {
+    out << "Reference " << report.reference << "\n";
+    out << std::format(
+        "Int8 ({}) Loss: {} | Accuracy: {} | Agreement: {:.1f}% | Weights: {:.1f} KiB -> {:.1f} KiB ({:.1f}x smaller)",
+        quantization::kernel_name(), report.quantized.loss, report.quantized.accuracy * 100.0,
+        report.agreement * 100.0, report.reference_bytes / 1024.0, report.quantized_bytes / 1024.0,
+        static_cast<double>(report.reference_bytes) / static_cast<double>(std::max<std::size_t>(report.quantized_bytes, 1))
+    );
+    return out;
+}
+
+template class QuantizedNetwork<float>;
+template class QuantizedNetwork<double>;
+
+template QuantizedNetwork<float>::QuantizedNetwork(const NeuralNetwork<float, float>&, const quantization::Settings&);
+template QuantizedNetwork<float>::QuantizedNetwork(const NeuralNetwork<float, double>&, const quantization::Settings&);
+template QuantizedNetwork<double>::QuantizedNetwork(const NeuralNetwork<double, double>&, const quantization::Settings&);
+template quantization::Report QuantizedNetwork<float>::compare(const NeuralNetwork<float, float>&, const MatrixView<float>&, const MatrixView<float>&, loss::Type) const;
+template quantization::Report QuantizedNetwork<float>::compare(const NeuralNetwork<float, double>&, const MatrixView<float>&, const MatrixView<float>&, loss::Type) const;
+template quantization::Report QuantizedNetwork<double>::compare(const NeuralNetwork<double, double>&, const MatrixView<double>&, const MatrixView<double>&, loss::Type) const;
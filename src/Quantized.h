@@ -0,0 +1,159 @@
+#pragma once
+
+#include "Activation.h"
+#include "Loss.h"
+#include "Matrix.h"
+#include "NeuralNetwork.h"
+#include "Performance.h"
+#include "Pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+/**
+ * @namespace quantization
+ * @brief Contains the settings and reports of the int8 inference engine.
+ */
+namespace quantization {
+
+    /**
+     * @enum Granularity
+     * @brief Enum representing how many scales are used to quantize the weights of a layer.
+     */
+    enum class Granularity {
+        PerLayer,   ///< One scale for the whole weight matrix
+        PerRow      ///< One scale per output neuron (row of the weight matrix)
+    };
+
+    /**
+     * @struct Settings
+     * @brief Represents the settings of the quantization.
+     */
+    struct Settings {
+        Granularity granularity = Granularity::PerRow;  ///< Weight scale granularity (default = PerRow)
+    };
+
+    /**
+     * @struct Report
+     * @brief Compares a quantized network with the network it was built from.
+     */
+    struct Report {
+        performance::metrics reference;     ///< Metrics of the floating point network
+        performance::metrics quantized;     ///< Metrics of the quantized network
+        double agreement = 0.0;             ///< Fraction of samples for which both predict the same class
+        std::size_t reference_bytes = 0;    ///< Size of the floating point weights
+        std::size_t quantized_bytes = 0;    ///< Size of the int8 weights and their scales
+    };
+
+    /**
+     * @brief Returns the name of the int8 dot product kernel selected for the running CPU.
+     * @return "AVX-512 VNNI", "AVX-VNNI", "AVX2" or "scalar".
+     */
+    [[nodiscard]] std::string_view kernel_name() noexcept;
+}
+
+/**
+ * @class QuantizedNetwork
+ * @brief Int8 inference copy of a trained network.
+ * @details Weights are quantized symmetrically to int8 once, per layer or per output row.
+ * Before every layer the activations are quantized asymmetrically to uint8, with a scale and
+ * zero point per sample, and the product is accumulated in int32 by a VNNI (or AVX2) kernel.
+ * The accumulators are then rescaled to floating point, the biases are added and the
+ * activation function (including the final softmax) runs in floating point.
+ * @tparam T Element type of the inputs and outputs.
+ */
+template <typename T>
+class QuantizedNetwork {
+public:
+    /**
+     * @brief Quantizes the weights of a trained network.
+     * @param network The trained network.
+     * @param settings The quantization settings.
+     */
+    template <typename Master>
+    explicit QuantizedNetwork(const NeuralNetwork<T, Master>& network, const quantization::Settings& settings = {});
+
+    /**
+     * @brief Predicts the output for the given input data.
+     * @param input The input data matrix, one sample per column.
+     * @return The predicted output matrix.
+     * @throws std::invalid_argument if the number of input rows does not match the first layer.
+     */
+    [[nodiscard]] Matrix<T> predict(const MatrixView<T>& input) const;
+
+    /**
+     * @brief Evaluates the quantized network's performance on the given input and labels.
+     * @param input The input data matrix.
+     * @param labels The label data matrix.
+     * @param loss_type The type of loss function to use for evaluation.
+     * @return A metrics object containing the loss and accuracy.
+     */
+    [[nodiscard]] performance::metrics evaluate(const MatrixView<T>& input, const MatrixView<T>& labels, loss::Type loss_type) const;
+
+    /**
+     * @brief Compares the quantized network with a reference network on the same data.
+     * @param reference The network to compare with, usually the one this copy was built from.
+     * @param input The input data matrix.
+     * @param labels The label data matrix.
+     * @param loss_type The type of loss function to use for evaluation.
+     * @return Metrics of both networks, their agreement and the size of their weights.
+     */
+    template <typename Master>
+    [[nodiscard]] quantization::Report compare(
+        const NeuralNetwork<T, Master>& reference,
+        const MatrixView<T>& input,
+        const MatrixView<T>& labels,
+        loss::Type loss_type
+    ) const;
+
+    /**
+     * @brief Returns the size of the int8 weights and their scales.
+     * @return Size in bytes.
+     */
+    [[nodiscard]] std::size_t weight_bytes() const noexcept;
+private:
+    /**
+     * @struct QuantizedLayer
+     * @brief Int8 weights of a layer and what is needed to rescale its products.
+     */
+    struct QuantizedLayer {
+        int input;                                          ///< Number of input features
+        int output;                                         ///< Number of output features
+        int stride;                                         ///< Row length of the weights, padded to a multiple of QUANT_ALIGN
+        std::vector<int8_t, pool::Allocator<int8_t>> weights;   ///< Quantized weights (output x stride), zero padded
+        std::vector<float> scales;                          ///< Scale of every weight row
+        std::vector<int32_t> row_sums;                      ///< Sum of every quantized weight row, to cancel the activation zero points
+        std::vector<T> biases;                              ///< Biases, kept in floating point
+        activation::Type activation;                        ///< Activation function of the layer
+    };
+
+    /**
+     * @brief Quantized layers, from input to output.
+     */
+    std::vector<QuantizedLayer> layers;
+
+    /**
+     * @brief Quantizes the weights of a layer.
+     */
+    [[nodiscard]] static QuantizedLayer quantize_layer(
+        const MatrixView<T>& weights,
+        const MatrixView<T>& biases,
+        activation::Type activation,
+        quantization::Granularity granularity
+    );
+
+    /**
+     * @brief Runs a layer on a batch of inputs into out.
+     */
+    static void predict_layer(const QuantizedLayer& layer, Matrix<T>& out, const MatrixView<T>& input);
+};
+
+/**
+ * @brief Outputs a quantization report to a stream.
+ * @param out Output stream.
+ * @param report Report to output.
+ * @return Reference to the output stream.
+ */
+std::ostream& operator<<(std::ostream& out, const quantization::Report& report);
@@ -1,23 +1,16 @@
 #include "Regularization.h"
 #include <stdexcept>
 
-Matrix regularization::term(
-    const Matrix& w, 
-    const regularization::Settings& settings
-) {
-    auto sign = [](double v) noexcept { 
-        return (v > 0.0) ? 1.0 : (v < 0.0 ? -1.0 : 0.0);
-    };
+regularization::Coefficients regularization::coefficients(const regularization::Settings& settings) {
     switch (settings.type) {
         case Type::L1:
-            return settings.lambda1 * w.apply(sign);
+            return {settings.lambda1, 0.0};
         case Type::L2:
-            return settings.lambda2 * w;
+            return {0.0, settings.lambda2};
         case Type::Elastic:
-            return settings.lambda1 * w.apply(sign) 
-                + settings.lambda2 * w;
+            return {settings.lambda1, settings.lambda2};
         case Type::None:
-            return Matrix(w.rows(), w.cols(), 0.0);
+            return {};
         default:
             throw std::invalid_argument("unknown regularization type");
     }
@@ -1,7 +1,5 @@
 #pragma once
 
-#include "Matrix.h"
-
 /**
  * @namespace regularization
  * @brief Contains functions and types related to regularization techniques.
@@ -30,14 +28,19 @@ namespace regularization {
     };
 
     /**
-     * @brief Computes the regularization term for a given matrix and settings.
-     * @param w The matrix to apply regularization to.
+     * @struct Coefficients
+     * @brief Coefficients of the L1 and L2 terms a regularization adds to the weight gradient.
+     */
+    struct Coefficients {
+        double l1 = 0.0;    ///< Coefficient of sign(w), zero when the type has no L1 term
+        double l2 = 0.0;    ///< Coefficient of w, zero when the type has no L2 term
+    };
+
+    /**
+     * @brief Returns the coefficients a regularization adds to the weight gradient.
      * @param settings The settings for the regularization.
-     * @return A new Matrix representing the regularization term.
+     * @return The L1 and L2 coefficients, so that the term is l1 * sign(w) + l2 * w.
      * @throws std::invalid_argument if an unknown regularization type is specified.
      */
-    [[nodiscard]] Matrix term(
-        const Matrix& w, 
-        const regularization::Settings& settings
-    );
+    [[nodiscard]] Coefficients coefficients(const regularization::Settings& settings);
 }
@@ -0,0 +1,607 @@
+#include "Simd.h"
+#include <concepts>
+#include <cstring>
+#include <immintrin.h>
+
+/**
+ * @enum Op
+ * @brief Element-wise operation carried out by a kernel.
+ */
+enum class Op { Add, Sub, Mul, Div, Set };
+
+/**
+ * @brief Applies an operation to a pair of scalars (used for the tails of the vector loops).
+ */
+template <Op op, typename T>
+[[nodiscard]] static inline T scalar_op(T x, T y) noexcept {
+    if constexpr (op == Op::Add) { return x + y; }
+    else if constexpr (op == Op::Sub) { return x - y; }
+    else if constexpr (op == Op::Mul) { return x * y; }
+    else if constexpr (op == Op::Div) { return x / y; }
+    else { return y; }
+}
+
+/* SSE2 */
+
+namespace sse2 {
+
+    [[gnu::target("sse2")]] static inline __m128d load(const double* p) noexcept { return _mm_loadu_pd(p); }
+    [[gnu::target("sse2")]] static inline __m128 load(const float* p) noexcept { return _mm_loadu_ps(p); }
+    [[gnu::target("sse2")]] static inline void store(double* p, __m128d x) noexcept { _mm_storeu_pd(p, x); }
+    [[gnu::target("sse2")]] static inline void store(float* p, __m128 x) noexcept { _mm_storeu_ps(p, x); }
+    [[gnu::target("sse2")]] static inline __m128d broadcast(double x) noexcept { return _mm_set1_pd(x); }
+    [[gnu::target("sse2")]] static inline __m128 broadcast(float x) noexcept { return _mm_set1_ps(x); }
+    [[gnu::target("sse2")]] static inline int zero_mask(__m128d x) noexcept { return _mm_movemask_pd(_mm_cmpeq_pd(x, _mm_setzero_pd())); }
+    [[gnu::target("sse2")]] static inline int zero_mask(__m128 x) noexcept { return _mm_movemask_ps(_mm_cmpeq_ps(x, _mm_setzero_ps())); }
+
+    template <Op op>
+    [[nodiscard, gnu::target("sse2")]] static inline __m128d vector_op(__m128d x, __m128d y) noexcept {
+        if constexpr (op == Op::Add) { return _mm_add_pd(x, y); }
+        else if constexpr (op == Op::Sub) { return _mm_sub_pd(x, y); }
+        else if constexpr (op == Op::Mul) { return _mm_mul_pd(x, y); }
+        else if constexpr (op == Op::Div) { return _mm_div_pd(x, y); }
+        else { return y; }
+    }
+
+    template <Op op>
+    [[nodiscard, gnu::target("sse2")]] static inline __m128 vector_op(__m128 x, __m128 y) noexcept {
+        if constexpr (op == Op::Add) { return _mm_add_ps(x, y); }
+        else if constexpr (op == Op::Sub) { return _mm_sub_ps(x, y); }
+        else if constexpr (op == Op::Mul) { return _mm_mul_ps(x, y); }
+        else if constexpr (op == Op::Div) { return _mm_div_ps(x, y); }
+        else { return y; }
+    }
+
+    template <typename T, Op op>
+    [[gnu::target("sse2")]] static bool binary(T* dst, const T* src, std::size_t n) noexcept {
+        constexpr std::size_t W = 16 / sizeof(T);
+        int zeros = 0;
+        std::size_t i { 0 };
+        for (; i + W <= n; i += W) {
+            const auto y = load(src + i);
+            if constexpr (op == Op::Div) { zeros |= zero_mask(y); }
+            store(dst + i, vector_op<op>(load(dst + i), y));
+        }
+        bool valid = zeros == 0;
+        for (; i < n; ++i) {
+            if constexpr (op == Op::Div) { valid = valid && src[i] != T { 0 }; }
+            dst[i] = scalar_op<op>(dst[i], src[i]);
+        }
+        return valid;
+    }
+
+    template <typename T, Op op>
+    [[gnu::target("sse2")]] static void broadcast_op(T* dst, T scalar, std::size_t n) noexcept {
+        constexpr std::size_t W = 16 / sizeof(T);
+        const auto y = broadcast(scalar);
+        std::size_t i { 0 };
+        for (; i + W <= n; i += W) {
+            store(dst + i, vector_op<op>(load(dst + i), y));
+        }
+        for (; i < n; ++i) {
+            dst[i] = scalar_op<op>(dst[i], scalar);
+        }
+    }
+
+    template <typename T>
+    [[gnu::target("sse2")]] static T sum(const T* src, std::size_t n) noexcept {
+        constexpr std::size_t W = 16 / sizeof(T);
+        auto acc0 = broadcast(T { 0 });
+        auto acc1 = broadcast(T { 0 });
+        std::size_t i { 0 };
+        for (; i + 2 * W <= n; i += 2 * W) {
+            acc0 = vector_op<Op::Add>(acc0, load(src + i));
+            acc1 = vector_op<Op::Add>(acc1, load(src + i + W));
+        }
+        T lanes[W];
+        store(lanes, vector_op<Op::Add>(acc0, acc1));
+        T total { 0 };
+        for (std::size_t lane { 0 }; lane < W; ++lane) {
+            total += lanes[lane];
+        }
+        for (; i < n; ++i) {
+            total += src[i];
+        }
+        return total;
+    }
+
+    template <typename T>
+    [[gnu::target("sse2")]] static void axpy(T* dst, T alpha, const T* src, std::size_t n) noexcept {
+        constexpr std::size_t W = 16 / sizeof(T);
+        const auto a = broadcast(alpha);
+        std::size_t i { 0 };
+        for (; i + W <= n; i += W) {
+            store(dst + i, vector_op<Op::Add>(load(dst + i), vector_op<Op::Mul>(a, load(src + i))));
+        }
+        for (; i < n; ++i) {
+            dst[i] += alpha * src[i];
+        }
+    }
+
+    template <typename T>
+    [[gnu::target("sse2")]] static void from_bytes(T* dst, const uint8_t* src, T divisor, std::size_t n) noexcept {
+        const auto d = broadcast(divisor);
+        const __m128i zero = _mm_setzero_si128();
+        std::size_t i { 0 };
+        for (; i + 4 <= n; i += 4) {
+            /* SSE2 has no zero-extending conversion: four bytes are unpacked against zero twice */
+            int32_t packed;
+            std::memcpy(&packed, src + i, 4);
+            const __m128i words = _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero);
+            const __m128i ints = _mm_unpacklo_epi16(words, zero);
+            if constexpr (std::same_as<T, double>) {
+                store(dst + i, vector_op<Op::Div>(_mm_cvtepi32_pd(ints), d));
+                store(dst + i + 2, vector_op<Op::Div>(_mm_cvtepi32_pd(_mm_srli_si128(ints, 8)), d));
+            } else {
+                store(dst + i, vector_op<Op::Div>(_mm_cvtepi32_ps(ints), d));
+            }
+        }
+        for (; i < n; ++i) {
+            dst[i] = static_cast<T>(src[i]) / divisor;
+        }
+    }
+
+    template <typename T>
+    [[gnu::target("sse2")]] static void transpose_tile(const T* src, std::ptrdiff_t src_stride, T* dst, std::ptrdiff_t dst_stride) noexcept {
+        if constexpr (std::same_as<T, double>) {
+            /* 4x4 tile as 2x2 blocks of 2x2, each transposed with one unpack pair */
+            for (int i { 0 }; i < 4; i += 2) {
+                for (int j { 0 }; j < 4; j += 2) {
+                    const __m128d r0 = load(src + i * src_stride + j);
+                    const __m128d r1 = load(src + (i + 1) * src_stride + j);
+                    store(dst + j * dst_stride + i, _mm_unpacklo_pd(r0, r1));
+                    store(dst + (j + 1) * dst_stride + i, _mm_unpackhi_pd(r0, r1));
+                }
+            }
+        } else {
+            /* 8x8 tile as 2x2 blocks of 4x4 */
+            for (int i { 0 }; i < 8; i += 4) {
+                for (int j { 0 }; j < 8; j += 4) {
+                    __m128 r0 = load(src + i * src_stride + j);
+                    __m128 r1 = load(src + (i + 1) * src_stride + j);
+                    __m128 r2 = load(src + (i + 2) * src_stride + j);
+                    __m128 r3 = load(src + (i + 3) * src_stride + j);
+                    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                    store(dst + j * dst_stride + i, r0);
+                    store(dst + (j + 1) * dst_stride + i, r1);
+                    store(dst + (j + 2) * dst_stride + i, r2);
+                    store(dst + (j + 3) * dst_stride + i, r3);
+                }
+            }
+        }
+    }
+}
+
+/* AVX2 */
+
+namespace avx2 {
+
+    [[gnu::target("avx2")]] static inline __m256d load(const double* p) noexcept { return _mm256_loadu_pd(p); }
+    [[gnu::target("avx2")]] static inline __m256 load(const float* p) noexcept { return _mm256_loadu_ps(p); }
+    [[gnu::target("avx2")]] static inline void store(double* p, __m256d x) noexcept { _mm256_storeu_pd(p, x); }
+    [[gnu::target("avx2")]] static inline void store(float* p, __m256 x) noexcept { _mm256_storeu_ps(p, x); }
+    [[gnu::target("avx2")]] static inline __m256d broadcast(double x) noexcept { return _mm256_set1_pd(x); }
+    [[gnu::target("avx2")]] static inline __m256 broadcast(float x) noexcept { return _mm256_set1_ps(x); }
+    [[gnu::target("avx2")]] static inline int zero_mask(__m256d x) noexcept { return _mm256_movemask_pd(_mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_EQ_OQ)); }
+    [[gnu::target("avx2")]] static inline int zero_mask(__m256 x) noexcept { return _mm256_movemask_ps(_mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_EQ_OQ)); }
+
+    template <Op op>
+    [[nodiscard, gnu::target("avx2")]] static inline __m256d vector_op(__m256d x, __m256d y) noexcept {
+        if constexpr (op == Op::Add) { return _mm256_add_pd(x, y); }
+        else if constexpr (op == Op::Sub) { return _mm256_sub_pd(x, y); }
+        else if constexpr (op == Op::Mul) { return _mm256_mul_pd(x, y); }
+        else if constexpr (op == Op::Div) { return _mm256_div_pd(x, y); }
+        else { return y; }
+    }
+
+    template <Op op>
+    [[nodiscard, gnu::target("avx2")]] static inline __m256 vector_op(__m256 x, __m256 y) noexcept {
+        if constexpr (op == Op::Add) { return _mm256_add_ps(x, y); }
+        else if constexpr (op == Op::Sub) { return _mm256_sub_ps(x, y); }
+        else if constexpr (op == Op::Mul) { return _mm256_mul_ps(x, y); }
+        else if constexpr (op == Op::Div) { return _mm256_div_ps(x, y); }
+        else { return y; }
+    }
+
+    template <typename T, Op op>
+    [[gnu::target("avx2")]] static bool binary(T* dst, const T* src, std::size_t n) noexcept {
+        constexpr std::size_t W = 32 / sizeof(T);
+        int zeros = 0;
+        std::size_t i { 0 };
+        for (; i + W <= n; i += W) {
+            const auto y = load(src + i);
+            if constexpr (op == Op::Div) { zeros |= zero_mask(y); }
+            store(dst + i, vector_op<op>(load(dst + i), y));
+        }
+        bool valid = zeros == 0;
+        for (; i < n; ++i) {
+            if constexpr (op == Op::Div) { valid = valid && src[i] != T { 0 }; }
+            dst[i] = scalar_op<op>(dst[i], src[i]);
+        }
+        return valid;
+    }
+
+    template <typename T, Op op>
+    [[gnu::target("avx2")]] static void broadcast_op(T* dst, T scalar, std::size_t n) noexcept {
+        constexpr std::size_t W = 32 / sizeof(T);
+        const auto y = broadcast(scalar);
+        std::size_t i { 0 };
+        for (; i + W <= n; i += W) {
+            store(dst + i, vector_op<op>(load(dst + i), y));
+        }
+        for (; i < n; ++i) {
+            dst[i] = scalar_op<op>(dst[i], scalar);
+        }
+    }
+
+    template <typename T>
+    [[gnu::target("avx2")]] static T sum(const T* src, std::size_t n) noexcept {
+        constexpr std::size_t W = 32 / sizeof(T);
+        auto acc0 = broadcast(T { 0 });
+        auto acc1 = broadcast(T { 0 });
+        std::size_t i { 0 };
+        for (; i + 2 * W <= n; i += 2 * W) {
+            acc0 = vector_op<Op::Add>(acc0, load(src + i));
+            acc1 = vector_op<Op::Add>(acc1, load(src + i + W));
+        }
+        T lanes[W];
+        store(lanes, vector_op<Op::Add>(acc0, acc1));
+        T total { 0 };
+        for (std::size_t lane { 0 }; lane < W; ++lane) {
+            total += lanes[lane];
+        }
+        for (; i < n; ++i) {
+            total += src[i];
+        }
+        return total;
+    }
+
+    template <typename T>
+    [[gnu::target("avx2")]] static void axpy(T* dst, T alpha, const T* src, std::size_t n) noexcept {
+        constexpr std::size_t W = 32 / sizeof(T);
+        const auto a = broadcast(alpha);
+        std::size_t i { 0 };
+        for (; i + W <= n; i += W) {
+            store(dst + i, vector_op<Op::Add>(load(dst + i), vector_op<Op::Mul>(a, load(src + i))));
+        }
+        for (; i < n; ++i) {
+            dst[i] += alpha * src[i];
+        }
+    }
+
+    template <typename T>
+    [[gnu::target("avx2")]] static void from_bytes(T* dst, const uint8_t* src, T divisor, std::size_t n) noexcept {
+        const auto d = broadcast(divisor);
+        std::size_t i { 0 };
+        for (; i + 8 <= n; i += 8) {
+            const __m256i ints = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+            if constexpr (std::same_as<T, double>) {
+                store(dst + i, vector_op<Op::Div>(_mm256_cvtepi32_pd(_mm256_castsi256_si128(ints)), d));
+                store(dst + i + 4, vector_op<Op::Div>(_mm256_cvtepi32_pd(_mm256_extracti128_si256(ints, 1)), d));
+            } else {
+                store(dst + i, vector_op<Op::Div>(_mm256_cvtepi32_ps(ints), d));
+            }
+        }
+        for (; i < n; ++i) {
+            dst[i] = static_cast<T>(src[i]) / divisor;
+        }
+    }
+
+    template <typename T>
+    [[gnu::target("avx2")]] static void transpose_tile(const T* src, std::ptrdiff_t src_stride, T* dst, std::ptrdiff_t dst_stride) noexcept {
+        if constexpr (std::same_as<T, double>) {
+            const __m256d r0 = load(src);
+            const __m256d r1 = load(src + src_stride);
+            const __m256d r2 = load(src + 2 * src_stride);
+            const __m256d r3 = load(src + 3 * src_stride);
+            const __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+            const __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+            const __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+            const __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+            store(dst, _mm256_permute2f128_pd(t0, t2, 0x20));
+            store(dst + dst_stride, _mm256_permute2f128_pd(t1, t3, 0x20));
+            store(dst + 2 * dst_stride, _mm256_permute2f128_pd(t0, t2, 0x31));
+            store(dst + 3 * dst_stride, _mm256_permute2f128_pd(t1, t3, 0x31));
+        } else {
+            __m256 r[8];
+            for (int i { 0 }; i < 8; ++i) {
+                r[i] = load(src + i * src_stride);
+            }
+            /* Interleave pairs of rows, then pairs of pairs, then swap the 128-bit halves */
+            __m256 t[8];
+            for (int i { 0 }; i < 8; i += 2) {
+                t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+                t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+            }
+            for (int i { 0 }; i < 8; i += 4) {
+                r[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+                r[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+                r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+                r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+            }
+            for (int i { 0 }; i < 4; ++i) {
+                store(dst + i * dst_stride, _mm256_permute2f128_ps(r[i], r[i + 4], 0x20));
+                store(dst + (i + 4) * dst_stride, _mm256_permute2f128_ps(r[i], r[i + 4], 0x31));
+            }
+        }
+    }
+}
+
+/* AVX-512 */
+
+namespace avx512 {
+
+    [[gnu::target("avx512f")]] static inline __m512d load(const double* p) noexcept { return _mm512_loadu_pd(p); }
+    [[gnu::target("avx512f")]] static inline __m512 load(const float* p) noexcept { return _mm512_loadu_ps(p); }
+    [[gnu::target("avx512f")]] static inline void store(double* p, __m512d x) noexcept { _mm512_storeu_pd(p, x); }
+    [[gnu::target("avx512f")]] static inline void store(float* p, __m512 x) noexcept { _mm512_storeu_ps(p, x); }
+    [[gnu::target("avx512f")]] static inline __m512d broadcast(double x) noexcept { return _mm512_set1_pd(x); }
+    [[gnu::target("avx512f")]] static inline __m512 broadcast(float x) noexcept { return _mm512_set1_ps(x); }
+    [[gnu::target("avx512f")]] static inline int zero_mask(__m512d x) noexcept { return _mm512_cmpeq_pd_mask(x, _mm512_setzero_pd()); }
+    [[gnu::target("avx512f")]] static inline int zero_mask(__m512 x) noexcept { return _mm512_cmpeq_ps_mask(x, _mm512_setzero_ps()); }
+
+    template <Op op>
+    [[nodiscard, gnu::target("avx512f")]] static inline __m512d vector_op(__m512d x, __m512d y) noexcept {
+        if constexpr (op == Op::Add) { return _mm512_add_pd(x, y); }
+        else if constexpr (op == Op::Sub) { return _mm512_sub_pd(x, y); }
+        else if constexpr (op == Op::Mul) { return _mm512_mul_pd(x, y); }
+        else if constexpr (op == Op::Div) { return _mm512_div_pd(x, y); }
+        else { return y; }
+    }
+
+    template <Op op>
+    [[nodiscard, gnu::target("avx512f")]] static inline __m512 vector_op(__m512 x, __m512 y) noexcept {
+        if constexpr (op == Op::Add) { return _mm512_add_ps(x, y); }
+        else if constexpr (op == Op::Sub) { return _mm512_sub_ps(x, y); }
+        else if constexpr (op == Op::Mul) { return _mm512_mul_ps(x, y); }
+        else if constexpr (op == Op::Div) { return _mm512_div_ps(x, y); }
+        else { return y; }
+    }
+
+    template <typename T, Op op>
+    [[gnu::target("avx512f")]] static bool binary(T* dst, const T* src, std::size_t n) noexcept {
+        constexpr std::size_t W = 64 / sizeof(T);
+        int zeros = 0;
+        std::size_t i { 0 };
+        for (; i + W <= n; i += W) {
+            const auto y = load(src + i);
+            if constexpr (op == Op::Div) { zeros |= zero_mask(y); }
+            store(dst + i, vector_op<op>(load(dst + i), y));
+        }
+        bool valid = zeros == 0;
+        for (; i < n; ++i) {
+            if constexpr (op == Op::Div) { valid = valid && src[i] != T { 0 }; }
+            dst[i] = scalar_op<op>(dst[i], src[i]);
+        }
+        return valid;
+    }
+
+    template <typename T, Op op>
+    [[gnu::target("avx512f")]] static void broadcast_op(T* dst, T scalar, std::size_t n) noexcept {
+        constexpr std::size_t W = 64 / sizeof(T);
+        const auto y = broadcast(scalar);
+        std::size_t i { 0 };
+        for (; i + W <= n; i += W) {
+            store(dst + i, vector_op<op>(load(dst + i), y));
+        }
+        for (; i < n; ++i) {
+            dst[i] = scalar_op<op>(dst[i], scalar);
+        }
+    }
+
+    template <typename T>
+    [[gnu::target("avx512f")]] static T sum(const T* src, std::size_t n) noexcept {
+        constexpr std::size_t W = 64 / sizeof(T);
+        auto acc0 = broadcast(T { 0 });
+        auto acc1 = broadcast(T { 0 });
+        std::size_t i { 0 };
+        for (; i + 2 * W <= n; i += 2 * W) {
+            acc0 = vector_op<Op::Add>(acc0, load(src + i));
+            acc1 = vector_op<Op::Add>(acc1, load(src + i + W));
+        }
+        T lanes[W];
+        store(lanes, vector_op<Op::Add>(acc0, acc1));
+        T total { 0 };
+        for (std::size_t lane { 0 }; lane < W; ++lane) {
+            total += lanes[lane];
+        }
+        for (; i < n; ++i) {
+            total += src[i];
+        }
+        return total;
+    }
+
+    template <typename T>
+    [[gnu::target("avx512f")]] static void axpy(T* dst, T alpha, const T* src, std::size_t n) noexcept {
+        constexpr std::size_t W = 64 / sizeof(T);
+        const auto a = broadcast(alpha);
+        std::size_t i { 0 };
+        for (; i + W <= n; i += W) {
+            store(dst + i, vector_op<Op::Add>(load(dst + i), vector_op<Op::Mul>(a, load(src + i))));
+        }
+        for (; i < n; ++i) {
+            dst[i] += alpha * src[i];
+        }
+    }
+
+    template <typename T>
+    [[gnu::target("avx512f")]] static void from_bytes(T* dst, const uint8_t* src, T divisor, std::size_t n) noexcept {
+        const auto d = broadcast(divisor);
+        constexpr std::size_t W = 64 / sizeof(T);
+        std::size_t i { 0 };
+        for (; i + W <= n; i += W) {
+            /* The zero-masked conversions avoid the undefined upper lanes GCC reports as uninitialized */
+            if constexpr (std::same_as<T, double>) {
+                const __m256i ints = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+                store(dst + i, vector_op<Op::Div>(_mm512_maskz_cvtepi32_pd(0xFF, ints), d));
+            } else {
+                const __m512i ints = _mm512_maskz_cvtepu8_epi32(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+                store(dst + i, vector_op<Op::Div>(_mm512_maskz_cvtepi32_ps(0xFFFF, ints), d));
+            }
+        }
+        for (; i < n; ++i) {
+            dst[i] = static_cast<T>(src[i]) / divisor;
+        }
+    }
+}
+
+/* Dispatch */
+
+/**
+ * @struct Kernels
+ * @brief Table of kernel entry points for one instruction set and element type.
+ */
+template <typename T>
+struct Kernels {
+    simd::Isa isa;
+    bool (*add)(T*, const T*, std::size_t) noexcept;
+    bool (*sub)(T*, const T*, std::size_t) noexcept;
+    bool (*mul)(T*, const T*, std::size_t) noexcept;
+    bool (*div)(T*, const T*, std::size_t) noexcept;
+    void (*scale)(T*, T, std::size_t) noexcept;
+    void (*div_scalar)(T*, T, std::size_t) noexcept;
+    void (*fill)(T*, T, std::size_t) noexcept;
+    T (*sum)(const T*, std::size_t) noexcept;
+    void (*axpy)(T*, T, const T*, std::size_t) noexcept;
+    void (*from_bytes)(T*, const uint8_t*, T, std::size_t) noexcept;
+    void (*transpose_tile)(const T*, std::ptrdiff_t, T*, std::ptrdiff_t) noexcept;
+};
+
+/**
+ * @brief Selects the kernel table for the widest instruction set supported by the CPU.
+ */
+template <typename T>
+[[nodiscard]] static Kernels<T> select() noexcept {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        using namespace avx512;
+        return {
+            simd::Isa::AVX512,
+            binary<T, Op::Add>, binary<T, Op::Sub>, binary<T, Op::Mul>, binary<T, Op::Div>,
+            broadcast_op<T, Op::Mul>, broadcast_op<T, Op::Div>, broadcast_op<T, Op::Set>,
+            sum<T>, axpy<T>, from_bytes<T>,
+            /* The tile is sized for 256-bit rows, so AVX-512 machines reuse the AVX2 shuffles */
+            avx2::transpose_tile<T>
+        };
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        using namespace avx2;
+        return {
+            simd::Isa::AVX2,
+            binary<T, Op::Add>, binary<T, Op::Sub>, binary<T, Op::Mul>, binary<T, Op::Div>,
+            broadcast_op<T, Op::Mul>, broadcast_op<T, Op::Div>, broadcast_op<T, Op::Set>,
+            sum<T>, axpy<T>, from_bytes<T>, transpose_tile<T>
+        };
+    }
+    using namespace sse2;
+    return {
+        simd::Isa::SSE2,
+        binary<T, Op::Add>, binary<T, Op::Sub>, binary<T, Op::Mul>, binary<T, Op::Div>,
+        broadcast_op<T, Op::Mul>, broadcast_op<T, Op::Div>, broadcast_op<T, Op::Set>,
+        sum<T>, axpy<T>, from_bytes<T>, transpose_tile<T>
+    };
+}
+
+/**
+ * @brief Returns the kernel table for an element type, selecting it on first use.
+ */
+template <typename T>
+[[nodiscard]] static const Kernels<T>& kernels() noexcept {
+    static const Kernels<T> table = select<T>();
+    return table;
+}
+
+simd::Isa simd::active() noexcept {
+    return kernels<double>().isa;
+}
+
+std::string_view simd::name(Isa isa) noexcept {
+    switch (isa) {
+        case Isa::SSE2:
+            return "SSE2";
+        case Isa::AVX2:
+            return "AVX2";
+        case Isa::AVX512:
+            return "AVX-512";
+        default:
+            return "unknown";
+    }
+}
+
+template <typename T>
+void simd::add(T* dst, const T* src, std::size_t n) noexcept {
+    kernels<T>().add(dst, src, n);
+}
+
+template <typename T>
+void simd::sub(T* dst, const T* src, std::size_t n) noexcept {
+    kernels<T>().sub(dst, src, n);
+}
+
+template <typename T>
+void simd::mul(T* dst, const T* src, std::size_t n) noexcept {
+    kernels<T>().mul(dst, src, n);
+}
+
+template <typename T>
+bool simd::div(T* dst, const T* src, std::size_t n) noexcept {
+    return kernels<T>().div(dst, src, n);
+}
+
+template <typename T>
+void simd::scale(T* dst, std::type_identity_t<T> scalar, std::size_t n) noexcept {
+    kernels<T>().scale(dst, scalar, n);
+}
+
+template <typename T>
+void simd::div_scalar(T* dst, std::type_identity_t<T> scalar, std::size_t n) noexcept {
+    kernels<T>().div_scalar(dst, scalar, n);
+}
+
+template <typename T>
+void simd::fill(T* dst, std::type_identity_t<T> value, std::size_t n) noexcept {
+    kernels<T>().fill(dst, value, n);
+}
+
+template <typename T>
+T simd::sum(const T* src, std::size_t n) noexcept {
+    return kernels<T>().sum(src, n);
+}
+
+template <typename T>
+void simd::axpy(T* dst, std::type_identity_t<T> alpha, const T* src, std::size_t n) noexcept {
+    kernels<T>().axpy(dst, alpha, src, n);
+}
+
+template <typename T>
+void simd::from_bytes(T* dst, const uint8_t* src, std::type_identity_t<T> divisor, std::size_t n) noexcept {
+    kernels<T>().from_bytes(dst, src, divisor, n);
+}
+
+template <typename T>
+void simd::transpose_tile(const T* src, std::ptrdiff_t src_stride, T* dst, std::ptrdiff_t dst_stride) noexcept {
+    kernels<T>().transpose_tile(src, src_stride, dst, dst_stride);
+}
+
+template void simd::add<float>(float*, const float*, std::size_t) noexcept;
+template void simd::add<double>(double*, const double*, std::size_t) noexcept;
+template void simd::sub<float>(float*, const float*, std::size_t) noexcept;
+template void simd::sub<double>(double*, const double*, std::size_t) noexcept;
+template void simd::mul<float>(float*, const float*, std::size_t) noexcept;
+template void simd::mul<double>(double*, const double*, std::size_t) noexcept;
+template bool simd::div<float>(float*, const float*, std::size_t) noexcept;
+template bool simd::div<double>(double*, const double*, std::size_t) noexcept;
+template void simd::scale<float>(float*, float, std::size_t) noexcept;
+template void simd::scale<double>(double*, double, std::size_t) noexcept;
+template void simd::div_scalar<float>(float*, float, std::size_t) noexcept;
+template void simd::div_scalar<double>(double*, double, std::size_t) noexcept;
+template void simd::fill<float>(float*, float, std::size_t) noexcept;
+template void simd::fill<double>(double*, double, std::size_t) noexcept;
+template float simd::sum<float>(const float*, std::size_t) noexcept;
+template double simd::sum<double>(const double*, std::size_t) noexcept;
+template void simd::axpy<float>(float*, float, const float*, std::size_t) noexcept;
+template void simd::axpy<double>(double*, double, const double*, std::size_t) noexcept;
+template void simd::from_bytes<float>(float*, const uint8_t*, float, std::size_t) noexcept;
+template void simd::from_bytes<double>(double*, const uint8_t*, double, std::size_t) noexcept;
+template void simd::transpose_tile<float>(const float*, std::ptrdiff_t, float*, std::ptrdiff_t) noexcept;
+template void simd::transpose_tile<double>(const double*, std::ptrdiff_t, double*, std::ptrdiff_t) noexcept;
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @namespace simd
+ * @brief Contains the vectorized element-wise kernels used by Matrix.
+ * @details Every kernel is compiled for SSE2, AVX2 and AVX-512, and the widest instruction
+ * set supported by the running CPU is selected once, the first time a kernel is called.
+ * The kernels are instantiated for float and double.
+ */
+namespace simd {
+
+    /**
+     * @enum Isa
+     * @brief Enum representing the instruction sets the kernels are compiled for.
+     */
+    enum class Isa {
+        SSE2,       ///< 128-bit vectors (baseline for x86-64)
+        AVX2,       ///< 256-bit vectors
+        AVX512      ///< 512-bit vectors
+    };
+
+    /**
+     * @brief Returns the instruction set selected for the running CPU.
+     * @return The active instruction set.
+     */
+    [[nodiscard]] Isa active() noexcept;
+
+    /**
+     * @brief Returns a printable name for an instruction set.
+     * @param isa The instruction set.
+     * @return Name of the instruction set.
+     */
+    [[nodiscard]] std::string_view name(Isa isa) noexcept;
+
+    /**
+     * @brief Adds src to dst element-wise (dst[i] += src[i]).
+     * @param dst Destination array.
+     * @param src Source array.
+     * @param n Number of elements.
+     */
+    template <typename T>
+    void add(T* dst, const T* src, std::size_t n) noexcept;
+
+    /**
+     * @brief Subtracts src from dst element-wise (dst[i] -= src[i]).
+     * @param dst Destination array.
+     * @param src Source array.
+     * @param n Number of elements.
+     */
+    template <typename T>
+    void sub(T* dst, const T* src, std::size_t n) noexcept;
+
+    /**
+     * @brief Multiplies dst by src element-wise (dst[i] *= src[i]).
+     * @param dst Destination array.
+     * @param src Source array.
+     * @param n Number of elements.
+     */
+    template <typename T>
+    void mul(T* dst, const T* src, std::size_t n) noexcept;
+
+    /**
+     * @brief Divides dst by src element-wise (dst[i] /= src[i]).
+     * @param dst Destination array.
+     * @param src Source array.
+     * @param n Number of elements.
+     * @return False if any element of src is zero, true otherwise.
+     * @note The division is carried out for every element even when a zero is found.
+     */
+    template <typename T>
+    [[nodiscard]] bool div(T* dst, const T* src, std::size_t n) noexcept;
+
+    /**
+     * @brief Multiplies every element of dst by a scalar.
+     * @param dst Destination array.
+     * @param scalar The scalar to multiply by.
+     * @param n Number of elements.
+     */
+    template <typename T>
+    void scale(T* dst, std::type_identity_t<T> scalar, std::size_t n) noexcept;
+
+    /**
+     * @brief Divides every element of dst by a scalar.
+     * @param dst Destination array.
+     * @param scalar The scalar to divide by.
+     * @param n Number of elements.
+     */
+    template <typename T>
+    void div_scalar(T* dst, std::type_identity_t<T> scalar, std::size_t n) noexcept;
+
+    /**
+     * @brief Sets every element of dst to a value.
+     * @param dst Destination array.
+     * @param value The value to fill with.
+     * @param n Number of elements.
+     */
+    template <typename T>
+    void fill(T* dst, std::type_identity_t<T> value, std::size_t n) noexcept;
+
+    /**
+     * @brief Sums the elements of an array.
+     * @param src Source array.
+     * @param n Number of elements.
+     * @return Sum of the elements.
+     */
+    template <typename T>
+    [[nodiscard]] T sum(const T* src, std::size_t n) noexcept;
+
+    /**
+     * @brief Adds a scaled array to dst element-wise (dst[i] += alpha * src[i]).
+     * @param dst Destination array.
+     * @param alpha The scalar to multiply src by.
+     * @param src Source array.
+     * @param n Number of elements.
+     */
+    template <typename T>
+    void axpy(T* dst, std::type_identity_t<T> alpha, const T* src, std::size_t n) noexcept;
+
+    /**
+     * @brief Converts bytes to floating point and divides them by a scalar (dst[i] = src[i] / divisor).
+     * @param dst Destination array.
+     * @param src Source bytes.
+     * @param divisor The scalar to divide by, such as 255 to normalize pixels to [0, 1].
+     * @param n Number of elements.
+     */
+    template <typename T>
+    void from_bytes(T* dst, const uint8_t* src, std::type_identity_t<T> divisor, std::size_t n) noexcept;
+
+    /**
+     * @brief Number of rows and columns of the tile handled by transpose_tile (one 256-bit row).
+     */
+    template <typename T>
+    inline constexpr int TILE = static_cast<int>(32 / sizeof(T));
+
+    /**
+     * @brief Transposes a TILE x TILE block in registers (dst[j][i] = src[i][j]).
+     * @param src First element of the source block.
+     * @param src_stride Distance between consecutive rows of the source.
+     * @param dst First element of the destination block.
+     * @param dst_stride Distance between consecutive rows of the destination.
+     * @note The source and destination blocks must not overlap.
+     */
+    template <typename T>
+    void transpose_tile(const T* src, std::ptrdiff_t src_stride, T* dst, std::ptrdiff_t dst_stride) noexcept;
+}
@@ -0,0 +1,170 @@
+#include "SparseMatrix.h"
+#include "Simd.h"
+#include "ThreadPool.h"
+#include <format>
+#include <stdexcept>
+
+template <typename T>
+SparseMatrix<T>::SparseMatrix(int rows)
+    : m_rows {rows}
+    , m_col_ptr {0}
+{
+    if (rows <= 0) {
+        throw std::invalid_argument(std::format(
+            "invalid matrix dimension ({}) must be >= 1",
+            rows
+        ));
+    }
+}
+
+template <typename T>
+SparseMatrix<T> SparseMatrix<T>::from_dense(const MatrixView<T>& dense) {
+    SparseMatrix sparse { dense.rows() };
+    sparse.m_col_ptr.reserve(static_cast<std::size_t>(dense.cols()) + 1);
+    for (int col { 0 }; col < dense.cols(); ++col) {
+        for (int row { 0 }; row < dense.rows(); ++row) {
+            if (dense[row, col] != T { 0 }) {
+                sparse.m_row_idx.push_back(row);
+                sparse.m_values.push_back(dense[row, col]);
+            }
+        }
+        sparse.m_col_ptr.push_back(static_cast<int>(sparse.m_values.size()));
+    }
+    return sparse;
+}
+
+template <typename T>
+Matrix<T> SparseMatrix<T>::to_dense() const {
+    Matrix<T> dense { m_rows, cols() };
+    for (int col { 0 }; col < cols(); ++col) {
+        for (int p { m_col_ptr[col] }; p < m_col_ptr[col + 1]; ++p) {
+            dense[m_row_idx[p], col] = m_values[p];
+        }
+    }
+    return dense;
+}
+
+template <typename T>
+double SparseMatrix<T>::density() const noexcept {
+    const double size = static_cast<double>(m_rows) * cols();
+    return size > 0.0 ? static_cast<double>(nnz()) / size : 0.0;
+}
+
+template <typename T>
+void SparseMatrix<T>::reserve(std::size_t nnz) {
+    m_row_idx.reserve(nnz);
+    m_values.reserve(nnz);
+}
+
+template <typename T>
+void SparseMatrix<T>::append_column(std::span<const T> column) {
+    if (static_cast<int>(column.size()) != m_rows) {
+        throw std::invalid_argument(std::format(
+            "mismatched column size {} must be {}", column.size(), m_rows
+        ));
+    }
+    for (int row { 0 }; row < m_rows; ++row) {
+        if (column[row] != T { 0 }) {
+            m_row_idx.push_back(row);
+            m_values.push_back(column[row]);
+        }
+    }
+    m_col_ptr.push_back(static_cast<int>(m_values.size()));
+}
+
+template <typename T>
+void SparseMatrix<T>::select_cols_into(SparseMatrix& out, const std::vector<int>& idx, int start, int end) const {
+    out.m_rows = m_rows;
+    out.m_col_ptr.assign(1, 0);
+    out.m_row_idx.clear();
+    out.m_values.clear();
+    for (int j { start }; j < end; ++j) {
+        const int col = idx[j];
+        const auto first = m_col_ptr[col];
+        const auto last = m_col_ptr[col + 1];
+        out.m_row_idx.insert(out.m_row_idx.end(), m_row_idx.begin() + first, m_row_idx.begin() + last);
+        out.m_values.insert(out.m_values.end(), m_values.begin() + first, m_values.begin() + last);
+        out.m_col_ptr.push_back(static_cast<int>(out.m_values.size()));
+    }
+}
+
+/**
+ * @brief Smallest share of the dense dimension given to a worker, one AVX-512 vector of floats.
+ */
+static constexpr std::size_t SPARSE_GRAIN = 16;
+
+template <typename T>
+void matmul_into(Matrix<T>& out, const ViewArg<T>& lhs, const SparseMatrix<T>& rhs) {
+    if (lhs.cols() != rhs.rows()) {
+        throw std::invalid_argument(std::format(
+            "mismatched matrix multiplication inner dimensions ({} and {})",
+            lhs.cols(), rhs.rows()
+        ));
+    }
+    const int rows = lhs.rows();
+    const int cols = rhs.cols();
+    /*
+     * Column j of the product is the sum of the columns k of lhs scaled by the stored elements
+     * of column j of rhs. Working on transposes turns each of them into a contiguous axpy.
+     */
+    Matrix<T> lhs_t = Matrix<T>::scratch(lhs.cols(), rows);
+    transpose_into(lhs_t, lhs);
+    Matrix<T> product_t = Matrix<T>::scratch(cols, rows);
+    product_t.fill(T { 0 });
+    const std::span<const int> col_ptr = rhs.col_ptr();
+    const std::span<const int> row_idx = rhs.row_indices();
+    const std::span<const T> values = rhs.values();
+    /* Each worker owns a slice of every output column */
+    parallel::for_each_chunk(static_cast<std::size_t>(rows), SPARSE_GRAIN, [&](std::size_t first, std::size_t last) {
+        const std::size_t width = last - first;
+        for (int col { 0 }; col < cols; ++col) {
+            T* product = &product_t[col, 0] + first;
+            for (int p { col_ptr[col] }; p < col_ptr[col + 1]; ++p) {
+                simd::axpy(product, values[p], &lhs_t[row_idx[p], 0] + first, width);
+            }
+        }
+    }, static_cast<std::size_t>(rows) * rhs.nnz());
+    transpose_into(out, product_t);
+}
+
+template <typename T>
+void matmul_nt_into(Matrix<T>& out, const ViewArg<T>& lhs, const SparseMatrix<T>& rhs) {
+    if (lhs.cols() != rhs.cols()) {
+        throw std::invalid_argument(std::format(
+            "mismatched matrix multiplication inner dimensions ({} and {})",
+            lhs.cols(), rhs.cols()
+        ));
+    }
+    const int rows = lhs.rows();
+    const int cols = lhs.cols();
+    /*
+     * Row k of the transposed product accumulates the columns j of lhs scaled by the stored
+     * elements of row k of rhs, so every stored element is one contiguous axpy.
+     */
+    Matrix<T> lhs_t = Matrix<T>::scratch(cols, rows);
+    transpose_into(lhs_t, lhs);
+    Matrix<T> product_t = Matrix<T>::scratch(rhs.rows(), rows);
+    product_t.fill(T { 0 });
+    const std::span<const int> col_ptr = rhs.col_ptr();
+    const std::span<const int> row_idx = rhs.row_indices();
+    const std::span<const T> values = rhs.values();
+    /* Each worker owns a slice of every output row, so the scattered updates never collide */
+    parallel::for_each_chunk(static_cast<std::size_t>(rows), SPARSE_GRAIN, [&](std::size_t first, std::size_t last) {
+        const std::size_t width = last - first;
+        for (int col { 0 }; col < cols; ++col) {
+            const T* scale = &lhs_t[col, 0] + first;
+            for (int p { col_ptr[col] }; p < col_ptr[col + 1]; ++p) {
+                simd::axpy(&product_t[row_idx[p], 0] + first, values[p], scale, width);
+            }
+        }
+    }, static_cast<std::size_t>(rows) * rhs.nnz());
+    transpose_into(out, product_t);
+}
+
+template class SparseMatrix<float>;
+template class SparseMatrix<double>;
+
+template void matmul_into(Matrix<float>&, const ViewArg<float>&, const SparseMatrix<float>&);
+template void matmul_into(Matrix<double>&, const ViewArg<double>&, const SparseMatrix<double>&);
+template void matmul_nt_into(Matrix<float>&, const ViewArg<float>&, const SparseMatrix<float>&);
+template void matmul_nt_into(Matrix<double>&, const ViewArg<double>&, const SparseMatrix<double>&);
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "Matrix.h"
+#include "MatrixView.h"
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/**
+ * @class SparseMatrix
+ * @brief Sparse matrix in compressed sparse column (CSC) format.
+ * @details Only the non-zero elements are stored, column by column: the rows and values of
+ * column j are at positions [col_ptr[j], col_ptr[j + 1]) of row_indices and values. Columns are
+ * samples in this library, so a batch of samples is a cheap gather of whole columns.
+ * Used for inputs that are mostly zeros, such as MNIST images, where the first layer
+ * multiplies the sparse input directly instead of a dense copy.
+ * @tparam T Element type.
+ */
+template <typename T>
+class SparseMatrix {
+public:
+    /**
+     * @brief Type of the elements.
+     */
+    using value_type = T;
+
+    /**
+     * @brief Constructs a matrix with the given number of rows and no columns, to be filled with append_column.
+     * @param rows Number of rows.
+     * @throws std::invalid_argument if rows is not positive.
+     */
+    explicit SparseMatrix(int rows);
+
+    /**
+     * @brief Builds a sparse copy of a dense matrix, keeping the elements that are not exactly zero.
+     * @param dense The dense matrix.
+     * @return A new SparseMatrix with the same elements.
+     */
+    [[nodiscard]] static SparseMatrix from_dense(const MatrixView<T>& dense);
+
+    /**
+     * @brief Builds a dense copy of the matrix.
+     * @return A new Matrix with the same elements.
+     */
+    [[nodiscard]] Matrix<T> to_dense() const;
+
+    /**
+     * @brief Returns the number of rows in the matrix.
+     * @return Number of rows.
+     */
+    [[nodiscard]] int rows() const noexcept { return m_rows; }
+
+    /**
+     * @brief Returns the number of columns in the matrix.
+     * @return Number of columns.
+     */
+    [[nodiscard]] int cols() const noexcept { return static_cast<int>(m_col_ptr.size()) - 1; }
+
+    /**
+     * @brief Returns the number of stored (non-zero) elements.
+     * @return Number of stored elements.
+     */
+    [[nodiscard]] std::size_t nnz() const noexcept { return m_values.size(); }
+
+    /**
+     * @brief Returns the fraction of the elements that are stored.
+     * @return Number of stored elements divided by rows x cols (0 for an empty matrix).
+     */
+    [[nodiscard]] double density() const noexcept;
+
+    /**
+     * @brief Returns the offsets of the columns in row_indices and values (cols() + 1 entries).
+     * @return Column offsets.
+     */
+    [[nodiscard]] std::span<const int> col_ptr() const noexcept { return m_col_ptr; }
+
+    /**
+     * @brief Returns the row of every stored element.
+     * @return Row indices, column by column.
+     */
+    [[nodiscard]] std::span<const int> row_indices() const noexcept { return m_row_idx; }
+
+    /**
+     * @brief Returns the value of every stored element.
+     * @return Values, column by column.
+     */
+    [[nodiscard]] std::span<const T> values() const noexcept { return m_values; }
+
+    /**
+     * @brief Reserves storage for a number of stored elements.
+     * @param nnz Expected number of stored elements.
+     */
+    void reserve(std::size_t nnz);
+
+    /**
+     * @brief Appends a dense column, keeping the elements that are not exactly zero.
+     * @param column The rows() elements of the column.
+     * @throws std::invalid_argument if column does not have rows() elements.
+     */
+    void append_column(std::span<const T> column);
+
+    /**
+     * @brief Gathers a range of columns, in a given order, into another sparse matrix.
+     * @param out Destination, whose storage is reused when large enough.
+     * @param idx The order of indices to select columns from.
+     * @param start The starting index for the range of columns to select.
+     * @param end The ending index for the range of columns to select.
+     * @note out must not be this matrix.
+     */
+    void select_cols_into(SparseMatrix& out, const std::vector<int>& idx, int start, int end) const;
+private:
+    /**
+     * @brief Number of rows in the matrix.
+     */
+    int m_rows;
+
+    /**
+     * @brief Offsets of the columns in m_row_idx and m_values.
+     */
+    std::vector<int> m_col_ptr;
+
+    /**
+     * @brief Row of every stored element.
+     */
+    std::vector<int> m_row_idx;
+
+    /**
+     * @brief Value of every stored element.
+     */
+    std::vector<T> m_values;
+};
+
+/**
+ * @brief Multiplies a dense matrix by a sparse matrix into a caller-owned destination.
+ * @param out Destination, resized to (lhs.rows() x rhs.cols()) only if its shape differs.
+ * @param lhs The dense left-hand side matrix, such as the weights of the first layer.
+ * @param rhs The sparse right-hand side matrix, such as a batch of inputs.
+ * @throws std::invalid_argument if the inner dimensions of the matrices do not match.
+ * @note Only the stored elements of rhs are visited: the cost is lhs.rows() x rhs.nnz().
+ */
+template <typename T>
+void matmul_into(Matrix<T>& out, const ViewArg<T>& lhs, const SparseMatrix<T>& rhs);
+
+/**
+ * @brief Multiplies a dense matrix by the transpose of a sparse matrix into a caller-owned destination (lhs * rhs^T).
+ * @param out Destination, resized to (lhs.rows() x rhs.rows()) only if its shape differs.
+ * @param lhs The dense left-hand side matrix, such as the deltas of the first layer.
+ * @param rhs The sparse matrix whose transpose to multiply with, such as a batch of inputs.
+ * @throws std::invalid_argument if the number of columns of both matrices do not match.
+ * @note Only the stored elements of rhs are visited: the cost is lhs.rows() x rhs.nnz().
+ */
+template <typename T>
+void matmul_nt_into(Matrix<T>& out, const ViewArg<T>& lhs, const SparseMatrix<T>& rhs);
@@ -0,0 +1,104 @@
+#include "ThreadPool.h"
+
+/**
+ * @brief Marks the threads owned by a pool, or marked by run_serially, so nested parallel calls run serially.
+ */
+static thread_local bool is_worker = false;
+
+/**
+ * @brief Settings used to build the process-wide pool.
+ */
+static parallel::Settings current_settings;
+
+/**
+ * @brief The process-wide pool, created on first use.
+ */
+static std::unique_ptr<parallel::ThreadPool> instance;
+
+/**
+ * @brief Guards the creation of the process-wide pool.
+ */
+static std::mutex instance_mutex;
+
+/**
+ * @brief Resolves the configured thread count (0 = hardware concurrency).
+ */
+[[nodiscard]] static int resolve_threads(int threads) noexcept {
+    if (threads > 0) {
+        return threads;
+    }
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+parallel::ThreadPool::ThreadPool(int threads) {
+    for (int worker { 1 }; worker < threads; ++worker) {
+        workers.emplace_back([this] { run(); });
+    }
+}
+
+parallel::ThreadPool::~ThreadPool() {
+    {
+        std::scoped_lock lock { mutex };
+        stopping = true;
+    }
+    available.notify_all();
+    workers.clear();
+}
+
+int parallel::ThreadPool::size() const noexcept {
+    return static_cast<int>(workers.size()) + 1;
+}
+
+bool parallel::ThreadPool::in_worker() noexcept {
+    return is_worker;
+}
+
+void parallel::ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::scoped_lock lock { mutex };
+        tasks.push_back(std::move(task));
+    }
+    available.notify_one();
+}
+
+void parallel::ThreadPool::run() {
+    is_worker = true;
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock { mutex };
+            available.wait(lock, [this] { return stopping || next_task < tasks.size(); });
+            if (next_task == tasks.size()) {
+                return;
+            }
+            task = std::move(tasks[next_task++]);
+            if (next_task == tasks.size()) {
+                tasks.clear();
+                next_task = 0;
+            }
+        }
+        task();
+    }
+}
+
+parallel::ThreadPool& parallel::pool() {
+    std::scoped_lock lock { instance_mutex };
+    if (!instance) {
+        instance = std::make_unique<ThreadPool>(resolve_threads(current_settings.threads));
+    }
+    return *instance;
+}
+
+void parallel::configure(const Settings& settings) {
+    std::scoped_lock lock { instance_mutex };
+    current_settings = settings;
+    instance = std::make_unique<ThreadPool>(resolve_threads(settings.threads));
+}
+
+const parallel::Settings& parallel::settings() noexcept {
+    return current_settings;
+}
+
+void parallel::run_serially() noexcept {
+    is_worker = true;
+}
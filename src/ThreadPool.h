@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @namespace parallel
+ * @brief Contains the process-wide thread pool used to split work across cores.
+ */
+namespace parallel {
+
+    /**
+     * @brief Default chunk size, in elements, used when splitting element-wise work.
+     * @note Kept a multiple of the widest SIMD vector so chunk boundaries stay aligned.
+     */
+    inline constexpr std::size_t GRAIN = 4096;
+
+    /**
+     * @struct Settings
+     * @brief Contains settings for the process-wide thread pool.
+     */
+    struct Settings {
+        int threads = 0;                    ///< Number of threads including the caller (default = 0 = hardware concurrency)
+        std::size_t threshold = 1 << 16;    ///< Minimum amount of work (elements or multiply-adds) before splitting (default = 65536)
+    };
+
+    /**
+     * @class ThreadPool
+     * @brief Fixed set of worker threads consuming a shared task queue.
+     * @details The thread calling for_range also executes chunks, so a pool of n threads
+     * owns n - 1 workers. Calls made from inside a worker run serially to avoid deadlocks.
+     */
+    class ThreadPool {
+    public:
+        /**
+         * @brief Constructs a thread pool.
+         * @param threads Number of threads including the caller (values below 1 are treated as 1).
+         */
+        explicit ThreadPool(int threads);
+
+        /**
+         * @brief Stops and joins all workers after the queued tasks finish.
+         */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Returns the number of threads available, including the caller.
+         * @return Number of threads.
+         */
+        [[nodiscard]] int size() const noexcept;
+
+        /**
+         * @brief Splits the range [begin, end) into chunks and runs f(chunk_begin, chunk_end) on each.
+         * @param begin Start of the range (inclusive).
+         * @param end End of the range (exclusive).
+         * @param grain Minimum chunk size (chunk boundaries are multiples of it, except the last).
+         * @param f Function called with the bounds of each chunk; must be safe to call concurrently.
+         * @note Blocks until every chunk has been processed and rethrows the first exception thrown.
+         */
+        template <typename Function>
+        void for_range(std::size_t begin, std::size_t end, std::size_t grain, Function&& f);
+
+        /**
+         * @brief Schedules a task on the pool.
+         * @param f The task to run.
+         * @return A future holding the result of the task.
+         */
+        template <typename Function>
+        [[nodiscard]] std::future<std::invoke_result_t<Function>> submit(Function&& f);
+
+        /**
+         * @brief Checks whether the calling thread is one of the pool workers.
+         * @return True if called from a worker thread, or from a thread marked by run_serially.
+         */
+        [[nodiscard]] static bool in_worker() noexcept;
+    private:
+        /**
+         * @brief Worker threads.
+         */
+        std::vector<std::jthread> workers;
+
+        /**
+         * @brief Pending tasks, consumed from next_task onwards.
+         * @note Kept as a vector that is cleared once drained, so queueing reuses its capacity instead of allocating.
+         */
+        std::vector<std::function<void()>> tasks;
+
+        /**
+         * @brief Index of the next task to run.
+         */
+        std::size_t next_task = 0;
+
+        /**
+         * @brief Mutex guarding the task queue.
+         */
+        std::mutex mutex;
+
+        /**
+         * @brief Signals workers when tasks are queued or the pool is stopping.
+         */
+        std::condition_variable available;
+
+        /**
+         * @brief Set when the pool is being destroyed.
+         */
+        bool stopping = false;
+
+        /**
+         * @brief Queues a task and wakes up a worker.
+         * @param task The task to queue.
+         */
+        void enqueue(std::function<void()> task);
+
+        /**
+         * @brief Main loop of each worker thread.
+         */
+        void run();
+    };
+
+    /**
+     * @brief Returns the process-wide thread pool, creating it on first use.
+     * @return Reference to the shared thread pool.
+     */
+    [[nodiscard]] ThreadPool& pool();
+
+    /**
+     * @brief Replaces the process-wide thread pool settings and recreates the pool.
+     * @param settings The new settings.
+     * @note Must not be called while work is running on the pool.
+     */
+    void configure(const Settings& settings);
+
+    /**
+     * @brief Returns the current thread pool settings.
+     * @return The active settings.
+     */
+    [[nodiscard]] const Settings& settings() noexcept;
+
+    /**
+     * @brief Makes the parallel calls of the calling thread run serially, as they do on a pool worker.
+     * @note For threads that already run concurrently with the pool, such as the prefetch workers.
+     */
+    void run_serially() noexcept;
+
+    /**
+     * @brief Runs f over [0, n) in chunks, splitting across the pool only when n reaches the threshold.
+     * @param n Size of the range (in elements).
+     * @param grain Minimum chunk size.
+     * @param f Function called with the bounds of each chunk.
+     * @param work Amount of work the range represents (default = n).
+     */
+    template <typename Function>
+    void for_each_chunk(std::size_t n, std::size_t grain, Function&& f, std::size_t work = 0);
+}
+
+template <typename Function>
+void parallel::ThreadPool::for_range(std::size_t begin, std::size_t end, std::size_t grain, Function&& f) {
+    if (begin >= end) {
+        return;
+    }
+    grain = std::max<std::size_t>(grain, 1);
+    const std::size_t blocks = (end - begin + grain - 1) / grain;
+    const std::size_t chunks = std::min<std::size_t>(blocks, static_cast<std::size_t>(size()));
+    if (chunks <= 1 || in_worker()) {
+        f(begin, end);
+        return;
+    }
+
+    /* Lives on this frame: each helper signals its exit while holding the mutex, so the caller cannot
+       return and destroy the job before the last helper is done touching it */
+    struct Job {
+        std::atomic<std::size_t> next {0};
+        std::size_t exited = 0;
+        std::size_t helpers = 0;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable all_exited;
+    } job;
+    job.helpers = chunks - 1;
+
+    const std::size_t per_chunk = (blocks + chunks - 1) / chunks * grain;
+    auto work = [&job, chunks, per_chunk, begin, end, &f] {
+        for (std::size_t chunk = job.next++; chunk < chunks; chunk = job.next++) {
+            const std::size_t first = begin + chunk * per_chunk;
+            const std::size_t last = std::min(end, first + per_chunk);
+            if (first < last) {
+                try {
+                    f(first, last);
+                } catch (...) {
+                    std::scoped_lock lock { job.mutex };
+                    if (!job.error) { job.error = std::current_exception(); }
+                }
+            }
+        }
+    };
+
+    /* Two references fit in the small buffer of std::function, so queueing a helper does not allocate */
+    for (std::size_t helper { 0 }; helper < job.helpers; ++helper) {
+        enqueue([&work, &job] {
+            work();
+            std::scoped_lock lock { job.mutex };
+            if (++job.exited == job.helpers) {
+                job.all_exited.notify_all();
+            }
+        });
+    }
+    work();
+
+    /* Every chunk has been claimed once work returns, and a helper only exits after finishing its own */
+    {
+        std::unique_lock lock { job.mutex };
+        job.all_exited.wait(lock, [&job] { return job.exited == job.helpers; });
+    }
+    if (job.error) {
+        std::rethrow_exception(job.error);
+    }
+}
+
+template <typename Function>
+std::future<std::invoke_result_t<Function>> parallel::ThreadPool::submit(Function&& f) {
+    using Result = std::invoke_result_t<Function>;
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(f));
+    std::future<Result> result = task->get_future();
+    if (workers.empty()) {
+        (*task)();
+    } else {
+        enqueue([task] { (*task)(); });
+    }
+    return result;
+}
+
+template <typename Function>
+void parallel::for_each_chunk(std::size_t n, std::size_t grain, Function&& f, std::size_t work) {
+    if ((work == 0 ? n : work) < settings().threshold) {
+        if (n > 0) { f(std::size_t { 0 }, n); }
+        return;
+    }
+    pool().for_range(0, n, grain, std::forward<Function>(f));
+}
@@ -1,21 +1,39 @@
 #include "Config.h"
 #include "DataLoader.h"
+#include "FixedNetwork.h"
 #include "NeuralNetwork.h"
+#include "Pool.h"
+#include "Quantized.h"
+#include "ThreadPool.h"
 #include <format>
 #include <iostream>
+#include <memory>
 
 int main() {
+    /* Parallelism */
+
+    parallel::configure({
+        .threads = 0,
+        .threshold = 1 << 16,
+    });
+
+    /* Precision: passes run in Scalar, weights are kept and updated in Master */
+
+    using Scalar = float;
+    using Master = double;
+
     /* Training Dataset */
 
     constexpr std::string_view train_images = "data/train-images-idx3-ubyte"; 
     constexpr std::string_view train_labels = "data/train-labels-idx1-ubyte";
 
+    /* Most pixels are zero: the images are kept sparse and the first layer skips them */
     auto [train_X, train_y] = 
-        mnist::load(train_images, train_labels, 1000);
+        mnist::load_sparse<Scalar>(train_images, train_labels, 1000);
 
     std::cout << std::format(
-        "Train Dataset: {} x {} | {} x {}\n",
-        train_X.rows(), train_X.cols(), train_y.rows(), train_y.cols()
+        "Train Dataset: {} x {} ({:.1f}% non-zero) | {} x {}\n",
+        train_X.rows(), train_X.cols(), 100.0 * train_X.density(), train_y.rows(), train_y.cols()
     );
     
     /* Testing Dataset */
@@ -24,7 +42,7 @@ int main() {
     constexpr std::string_view test_labels = "data/t10k-labels-idx1-ubyte";
 
     auto [test_X, test_y] = 
-        mnist::load(test_images, test_labels, 100);
+        mnist::load<Scalar>(test_images, test_labels, 100, {.decode = mnist::Decode::Parallel});
 
     std::cout << std::format(
         "Test Dataset: {} x {} | {} x {}\n",
@@ -54,7 +72,7 @@ int main() {
         },
     };
 
-    NeuralNetwork model { network_config };
+    NeuralNetwork<Scalar, Master> model { network_config };
 
     config::Training training_config {
         .epochs = 100,
@@ -66,9 +84,13 @@ int main() {
             .k = 0.05,
         },
         .best_model = true,
+        .prefetch = {
+            .workers = 1,
+            .depth = 4,
+        },
     };
 
-    config::Validation validation { 
+    config::Validation<Scalar> validation { 
         .X = test_X, 
         .y = test_y,
         .early_stop = true,
@@ -77,5 +99,18 @@ int main() {
 
     model.fit(train_X, train_y, training_config, validation);
 
+    /* Fixed-Shape Inference: layer widths as template parameters */
+
+    const auto deployed = std::make_unique<FixedNetwork<Scalar, 784, 64, 64, 10>>(model);
+    const Matrix<Scalar> predictions = deployed->predict(test_X);
+    std::cout << std::format("Fixed network predictions: {} x {}\n", predictions.rows(), predictions.cols());
+
+    /* Int8 Inference: quantized weights, compared with the trained network */
+
+    const QuantizedNetwork<Scalar> quantized { model };
+    std::cout << quantized.compare(model, test_X, test_y, loss::Type::CrossEntropy) << '\n';
+
+    std::cout << pool::stats() << '\n';
+
     return 0;
 }